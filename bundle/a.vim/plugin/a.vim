@@ -127,6 +127,17 @@ if (!exists('g:alternateRelativeFiles'))
    let g:alternateRelativeFiles = 0
 endif
 
+" If this variable is true then a.vim will load the alternate of each file shown
+" into a hidden, unlisted buffer once vim has been idle for
+" g:alternatePreloadDelay milliseconds, so that the first :A does not have to
+" read the file and load its syntax. It is wiped again when the file is hidden.
+if (!exists('g:alternatePreload'))
+   let g:alternatePreload = has("timers")
+endif
+if (!exists('g:alternatePreloadDelay'))
+   let g:alternatePreloadDelay = 300
+endif
+
 
 " Function : GetNthItemFromList (PRIVATE)
 " Purpose  : Support reading items from a comma seperated list
@@ -419,6 +430,57 @@ function! DetermineExtension(path)
   return ""
 endfunction
 
+" Function : FindAlternate (PRIVATE)
+" Purpose  : Finds the best alternate of a file without opening it. Files in
+"            memory are favored over files on disk.
+" Args     : path -- full path of the file
+" Returns  : [bestFile, bestScore, allfiles], allfiles is "" if no alternate
+"            is known for the extension. bestScore is the BufferOrFileExists()
+"            score of bestFile.
+" History  : Split out of AlternateFile so that the alternate can be found
+"            for a buffer which is not the current one.
+function! <SID>FindAlternate(path)
+  let extension   = DetermineExtension(a:path)
+  let baseName    = substitute(fnamemodify(a:path, ":t"), "\." . extension . '$', "", "")
+  let currentPath = fnamemodify(a:path, ":h")
+
+  let allfiles = ""
+  if (extension != "")
+     let allfiles1 = EnumerateFilesByExtension(currentPath, baseName, extension)
+     let allfiles2 = EnumerateFilesByExtensionInPath(baseName, extension, g:alternateSearchPath, currentPath)
+
+     if (allfiles1 != "")
+        if (allfiles2 != "")
+           let allfiles = allfiles1 . ',' . allfiles2
+        else
+           let allfiles = allfiles1
+        endif
+     else 
+        let allfiles = allfiles2
+     endif
+  endif
+
+  let bestFile = ""
+  let bestScore = 0
+  if (allfiles != "") 
+     let score = 0
+     let n = 1
+      
+     let onefile = <SID>GetNthItemFromList(allfiles, n)
+     let bestFile = onefile
+     while (onefile != "" && score < 2)
+        let score = <SID>BufferOrFileExists(onefile)
+        if (score > bestScore)
+           let bestScore = score
+           let bestFile = onefile
+        endif
+        let n = n + 1
+        let onefile = <SID>GetNthItemFromList(allfiles, n)
+     endwhile
+  endif
+  return [bestFile, bestScore, allfiles]
+endfunction
+
 " Function : AlternateFile (PUBLIC)
 " Purpose  : Opens a new buffer by looking at the extension of the current
 "            buffer and finding the corresponding file. E.g. foo.c <--> foo.h
@@ -441,40 +503,9 @@ function! AlternateFile(splitWindow, ...)
      let newFullname = currentPath . "/" .  baseName . "." . a:1
      call <SID>FindOrCreateBuffer(newFullname, a:splitWindow, 0)
   else
-     let allfiles = ""
-     if (extension != "")
-        let allfiles1 = EnumerateFilesByExtension(currentPath, baseName, extension)
-        let allfiles2 = EnumerateFilesByExtensionInPath(baseName, extension, g:alternateSearchPath, currentPath)
-
-        if (allfiles1 != "")
-           if (allfiles2 != "")
-              let allfiles = allfiles1 . ',' . allfiles2
-           else
-              let allfiles = allfiles1
-           endif
-        else 
-           let allfiles = allfiles2
-        endif
-     endif
+     let [bestFile, bestScore, allfiles] = <SID>FindAlternate(expand("%:p"))
 
      if (allfiles != "") 
-        let bestFile = ""
-        let bestScore = 0
-        let score = 0
-        let n = 1
-         
-        let onefile = <SID>GetNthItemFromList(allfiles, n)
-        let bestFile = onefile
-        while (onefile != "" && score < 2)
-           let score = <SID>BufferOrFileExists(onefile)
-           if (score > bestScore)
-              let bestScore = score
-              let bestFile = onefile
-           endif
-           let n = n + 1
-           let onefile = <SID>GetNthItemFromList(allfiles, n)
-        endwhile
-
         if (bestScore == 0 && g:alternateNoDefaultAlternate == 1)
            echo "No existing alternate available"
         else
@@ -635,6 +666,161 @@ comm! -nargs=? -bang AV call AlternateFile("v<bang>", <f-args>)
 comm! -nargs=? -bang AT call AlternateFile("t<bang>", <f-args>)
 comm! -nargs=? -bang AN call NextAlternate("<bang>")
 
+" Buffers loaded by PreloadAlternate which have not been entered yet.
+" bufnr => bufnr of the file they were loaded for
+let s:preloaded = {}
+let s:preloadTimer = -1
+let s:preloadOwner = -1
+let s:preloading = 0
+
+" Function : SchedulePreload (PRIVATE)
+" Purpose  : Remembers the buffer just read or shown and (re)starts the idle
+"            timer which preloads its alternate.
+" Args     : bufNr -- the buffer just read or shown
+" Returns  : nothing
+function! <SID>SchedulePreload(bufNr)
+   if (!g:alternatePreload || bufname(a:bufNr) == "" || getbufvar(a:bufNr, "&buftype") != "")
+      return
+   endif
+   if (has_key(s:preloaded, a:bufNr))
+      " Reading a preloaded buffer, don't chain to its alternate.
+      return
+   endif
+   let s:preloadOwner = a:bufNr
+   call timer_stop(s:preloadTimer)
+   let s:preloadTimer = timer_start(g:alternatePreloadDelay, function('<SID>PreloadAlternate'))
+endfunction
+
+" Function : PreloadAlternate (PRIVATE)
+" Purpose  : Timer callback. Loads the alternate of s:preloadOwner into a
+"            hidden unlisted buffer with its filetype and syntax set. Only
+"            an existing file which :A would open is loaded.
+" Args     : timer -- the timer id
+" Returns  : nothing
+function! <SID>PreloadAlternate(timer)
+   let s:preloadTimer = -1
+   if (exists("*state") && state("ma") != "")
+      " Keys are pending, try again when vim is idle.
+      let s:preloadTimer = timer_start(g:alternatePreloadDelay, function('<SID>PreloadAlternate'))
+      return
+   endif
+   let ownerNr = s:preloadOwner
+   if (!bufloaded(ownerNr) || empty(win_findbuf(ownerNr)))
+      " Its preload would be wiped again right away, see PreloadOwnerHidden.
+      return
+   endif
+   let [bestFile, bestScore, allfiles] = <SID>FindAlternate(fnamemodify(bufname(ownerNr), ":p"))
+   if (bestScore == 0 || !filereadable(bestFile))
+      return
+   endif
+
+   let fullName = fnamemodify(simplify(bestFile), ":p")
+   let bufNr = -1
+   let lastBuffer = bufnr("$")
+   let i = 1
+   while i <= lastBuffer
+     if <SID>EqualFilePaths(expand("#".i.":p"), fullName)
+       let bufNr = i
+       break
+     endif
+     let i = i + 1
+   endwhile
+   if (bufNr == -1 && bestScore == 2)
+      " :A would pick a buffer with the same name in another directory.
+      return
+   endif
+   if (bufNr != -1 && bufloaded(bufNr))
+      return
+   endif
+
+   if (bufNr == -1)
+      let bufNr = bufadd(fullName)
+      call setbufvar(bufNr, "&buflisted", 0)
+   endif
+   let s:preloaded[bufNr] = ownerNr
+   " bufload() triggers BufRead, which detects the filetype, which in turn
+   " loads the syntax. It also triggers BufEnter, which must not list it.
+   let s:preloading = 1
+   silent! call bufload(bufNr)
+   let s:preloading = 0
+   if (!bufloaded(bufNr))
+      call remove(s:preloaded, bufNr)
+   endif
+endfunction
+
+" Function : PreloadEntered (PRIVATE)
+" Purpose  : Makes a preloaded buffer a normal listed buffer once it is shown.
+" Args     : bufNr -- the buffer entered
+" Returns  : nothing
+function! <SID>PreloadEntered(bufNr)
+   if (!s:preloading && has_key(s:preloaded, a:bufNr))
+      call remove(s:preloaded, a:bufNr)
+      call setbufvar(a:bufNr, "&buflisted", 1)
+   endif
+endfunction
+
+" Function : PreloadOwnerDeleted (PRIVATE)
+" Purpose  : Wipes the preloaded alternates of a deleted buffer which were
+"            never used.
+" Args     : bufNr -- the buffer being deleted
+" Returns  : nothing
+function! <SID>PreloadOwnerDeleted(bufNr)
+   if (has_key(s:preloaded, a:bufNr))
+      call remove(s:preloaded, a:bufNr)
+   endif
+   call <SID>WipePreloads(a:bufNr)
+endfunction
+
+" Function : PreloadOwnerHidden (PRIVATE)
+" Purpose  : Wipes the unused preloaded alternates of a buffer which has been
+"            hidden. They are unlisted, so with 'hidden' set a buffer reaper
+"            which only looks at listed buffers would keep them loaded. This
+"            is done from a timer, as the buffer may be left for its
+"            preloaded alternate (:A), which must not be wiped while being
+"            entered.
+" Args     : bufNr -- the buffer being hidden
+" Returns  : nothing
+function! <SID>PreloadOwnerHidden(bufNr)
+   if (index(values(s:preloaded), a:bufNr) >= 0)
+      call timer_start(0, function('<SID>PreloadOwnerStillHidden', [a:bufNr]))
+   endif
+endfunction
+
+" Function : PreloadOwnerStillHidden (PRIVATE)
+" Purpose  : Timer callback of PreloadOwnerHidden.
+" Args     : bufNr -- the buffer which was hidden
+"            timer -- the timer id
+" Returns  : nothing
+function! <SID>PreloadOwnerStillHidden(bufNr, timer)
+   if (empty(win_findbuf(a:bufNr)))
+      call <SID>WipePreloads(a:bufNr)
+   endif
+endfunction
+
+" Function : WipePreloads (PRIVATE)
+" Purpose  : Wipes the preloaded alternates of a buffer which were never
+"            used. One which was a listed buffer already is only unloaded.
+" Args     : ownerNr -- the buffer they were loaded for
+" Returns  : nothing
+function! <SID>WipePreloads(ownerNr)
+   for [nr, ownerNr] in items(s:preloaded)
+      if (ownerNr == a:ownerNr && empty(win_findbuf(nr + 0)) && !getbufvar(nr + 0, "&modified"))
+         call remove(s:preloaded, nr)
+         silent! execute (buflisted(nr + 0) ? "bunload " : "bwipeout ") . nr
+      endif
+   endfor
+endfunction
+
+if (has("timers"))
+   augroup alternatePreload
+      au!
+      au BufReadPost,BufWinEnter * call <SID>SchedulePreload(expand("<abuf>") + 0)
+      au BufEnter * call <SID>PreloadEntered(expand("<abuf>") + 0)
+      au BufHidden * call <SID>PreloadOwnerHidden(expand("<abuf>") + 0)
+      au BufDelete * call <SID>PreloadOwnerDeleted(expand("<abuf>") + 0)
+   augroup END
+endif
+
 " Function : BufferOrFileExists (PRIVATE)
 " Purpose  : determines if a buffer or a readable file exists
 " Args     : fileName (IN) - name of the file to check
@@ -386,6 +386,21 @@ function! ctrlp#funky#clear_cache_all()
   call s:cache.clear_all()
 endfunction
 
+" returns {name: {'entries': n, 'bytes': n}}, bytes is approximate
+function! ctrlp#funky#memory_usage()
+  return {
+  \ 'cache.list': { 'entries': len(s:cache.list), 'bytes': len(string(s:cache.list)) },
+  \ 'mru.buffers': { 'entries': len(s:mru.buffers), 'bytes': len(string(s:mru.buffers)) },
+  \ }
+endfunction
+
+" releases in-memory caches, cache files are kept
+function! ctrlp#funky#trim()
+  " the list is read from cache files again when needed
+  let s:cache.list = {}
+  call filter(s:mru.buffers, 'bufexists(str2nr(v:key))')
+endfunction
+
 ""
 " Configuration
 "
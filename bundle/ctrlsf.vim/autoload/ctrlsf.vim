@@ -12,11 +12,23 @@
 " remember what user is searching
 let s:current_query = ''
 
+" handle of search for the rest files with 'g:ctrlsf_recent_first'
+let s:rest = {}
+
+" at most so many recent files are searched first
+let s:recent_limit = 100
+
 " s:ExecSearch()
 "
 " Basic process: query, parse, render and display.
 "
+" With 'g:ctrlsf_recent_first', recent files are searched and displayed
+" first, then the other files are searched in background.
+"
 func! s:ExecSearch(args) abort
+    call s:LiveStop()
+    call s:RestStop()
+
     try
         call ctrlsf#opt#ParseOptions(a:args)
     catch /ParseOptionsException/
@@ -27,7 +39,8 @@ func! s:ExecSearch(args) abort
         return -1
     endif
 
-    let [success, output] = ctrlsf#backend#Run(a:args)
+    let recent = s:RecentFiles()
+    let [success, output] = ctrlsf#backend#Run(a:args, recent)
     if !success
         call ctrlsf#log#Error('Failed to call backend. Error messages: %s',
             \ output)
@@ -35,10 +48,77 @@ func! s:ExecSearch(args) abort
     endif
 
     call ctrlsf#db#ParseAckprgResult(output)
+    if !empty(recent)
+        call ctrlsf#db#SortByFiles(recent)
+        let s:rest = ctrlsf#backend#RunAsync(a:args, function('s:RestDone'),
+            \ [], recent)
+    endif
+
     call ctrlsf#win#OpenMainWindow()
     call ctrlsf#win#Draw()
     call ctrlsf#buf#ClearUndoHistory()
     call cursor(1, 1)
+    call ctrlsf#LoadVisibleContext()
+endf
+
+" s:RecentFiles()
+"
+" Return recent files to search first, or [] if they should not be searched
+" separately.
+"
+func! s:RecentFiles() abort
+    if !g:ctrlsf_recent_first || !has('job')
+        \ || !empty(ctrlsf#opt#GetOpt('path'))
+        \ || ctrlsf#opt#IsOptGiven('changed')
+        return []
+    endif
+
+    let root = ctrlsf#backend#Root()
+    if !isdirectory(root)
+        return []
+    endif
+
+    return ctrlsf#fs#RecentFiles(root, s:recent_limit)
+endf
+
+" s:RestDone()
+"
+" Append result of the rest files after what has been displayed.
+"
+func! s:RestDone(success, output) abort
+    let s:rest = {}
+
+    if !a:success
+        call ctrlsf#log#Error('Failed to call backend. Error messages: %s',
+            \ a:output)
+        return
+    endif
+
+    " do not throw away changes in edit mode
+    let winnr = ctrlsf#win#FindMainWindow()
+    if winnr != -1 && getbufvar(winbufnr(winnr), '&modified')
+        call ctrlsf#log#Warn("Result is being edited, results of other files"
+            \ . " are discarded. Run :CtrlSFUpdate to search again.")
+        return
+    endif
+
+    if ctrlsf#db#AppendAckprgResult(a:output) == 0 || winnr == -1
+        return
+    endif
+
+    let winid = win_getid()
+    call ctrlsf#win#FocusMainWindow()
+    call ctrlsf#Redraw()
+    call ctrlsf#buf#ClearUndoHistory()
+    call ctrlsf#LoadVisibleContext()
+    call win_gotoid(winid)
+endf
+
+" s:RestStop()
+"
+func! s:RestStop() abort
+    call ctrlsf#backend#Stop(s:rest)
+    let s:rest = {}
 endf
 
 " Search()
@@ -56,6 +136,179 @@ func! ctrlsf#Search(args) abort
     call s:ExecSearch(s:current_query)
 endf
 
+" Live()
+"
+" Search as you type in a prompt. Pattern is searched after a short pause
+" (g:ctrlsf_live_delay), stopping the search in progress. If the pattern is a
+" literal extension of last finished one, result is narrowed in memory
+" instead of searching again.
+"
+" <CR> keeps result, <Esc> cancels the pending search.
+"
+func! ctrlsf#Live(args) abort
+    if !has('job') || !has('timers')
+        call ctrlsf#log#Error("Live mode requires Vim compiled with +job and
+            \ +timers.")
+        return -1
+    endif
+
+    if ctrlsf#backend#SelfCheck() < 0
+        return -1
+    endif
+
+    call s:LiveStop()
+    call s:RestStop()
+    let s:live = {
+        \ 'handle'  : {},
+        \ 'timer'   : -1,
+        \ 'query'   : a:args,
+        \ 'done'    : '',
+        \ 'opened'  : 0,
+        \ }
+
+    " search is started by timer and drawn by job callback, both run while
+    " getchar() is waiting for next key
+    call s:LivePrompt()
+    if !empty(s:live.query)
+        call s:LiveSchedule()
+    endif
+
+    while 1
+        let char = getchar()
+        let query = s:live.query
+
+        if char == 13 || char == 10
+            break
+        elseif char == 27 || char == 3
+            call s:LiveStop()
+            break
+        elseif char is# "\<BS>" || char == 8
+            let query = substitute(query, '.$', '', '')
+        elseif char == 21
+            let query = ''
+        elseif char == 23
+            let query = substitute(query, '\S*\s*$', '', '')
+        elseif type(char) == type(0) && char >= 32
+            let query .= nr2char(char)
+        else
+            continue
+        endif
+
+        let s:live.query = query
+        call s:LivePrompt()
+        call s:LiveSchedule()
+    endwh
+
+    call timer_stop(s:live.timer)
+    redraw
+    echo ''
+
+    if !empty(s:live.query)
+        let s:current_query = s:live.query
+    endif
+endf
+
+" s:LivePrompt()
+"
+func! s:LivePrompt() abort
+    redraw
+    echo 'CtrlSF> ' . s:live.query
+endf
+
+" s:LiveSchedule()
+"
+" Search current query after 'g:ctrlsf_live_delay' ms unless another key is
+" typed before.
+"
+func! s:LiveSchedule() abort
+    call timer_stop(s:live.timer)
+    let s:live.timer = timer_start(g:ctrlsf_live_delay,
+        \ {-> s:LiveSearch(s:live.query)})
+endf
+
+" s:LiveSearch()
+"
+func! s:LiveSearch(query) abort
+    call ctrlsf#backend#Stop(s:live.handle)
+    let s:live.handle = {}
+
+    if empty(a:query)
+        return
+    endif
+
+    " do not complain about options which are still being typed
+    try
+        silent call ctrlsf#opt#ParseOptions(a:query)
+    catch /ParseOptionsException/
+        return
+    endtry
+
+    if s:LiveNarrowable(a:query)
+        call ctrlsf#db#Narrow()
+        call s:LiveDraw(a:query)
+        return
+    endif
+
+    let s:live.handle = ctrlsf#backend#RunAsync(a:query,
+        \ function('s:LiveDone', [a:query]))
+endf
+
+" s:LiveNarrowable()
+"
+" A query can be narrowed if it is a single literal pattern (no arguments or
+" paths), which starts with the query of last finished search.
+"
+func! s:LiveNarrowable(query) abort
+    return !empty(s:live.done)
+        \ && stridx(a:query, s:live.done) == 0
+        \ && a:query !~ '\s' && s:live.done !~ '^-'
+        \ && !ctrlsf#opt#GetRegex()
+endf
+
+" s:LiveDone()
+"
+func! s:LiveDone(query, success, output) abort
+    let s:live.handle = {}
+
+    if !a:success
+        call ctrlsf#log#Error('Failed to call backend. Error messages: %s',
+            \ a:output)
+        return
+    endif
+
+    call ctrlsf#db#ParseAckprgResult(a:output)
+    call s:LiveDraw(a:query)
+endf
+
+" s:LiveDraw()
+"
+func! s:LiveDraw(query) abort
+    let s:live.done = a:query
+
+    " backup caller window only once
+    if !s:live.opened || ctrlsf#win#FocusMainWindow() == -1
+        call ctrlsf#win#OpenMainWindow()
+        let s:live.opened = 1
+    endif
+
+    call ctrlsf#win#Draw()
+    call ctrlsf#buf#ClearUndoHistory()
+    call ctrlsf#hl#HighlightMatch('ctrlsfMatch')
+    call cursor(1, 1)
+    call ctrlsf#LoadVisibleContext()
+    call s:LivePrompt()
+endf
+
+" s:LiveStop()
+"
+func! s:LiveStop() abort
+    if exists('s:live')
+        call timer_stop(s:live.timer)
+        call ctrlsf#backend#Stop(s:live.handle)
+        let s:live.handle = {}
+    endif
+endf
+
 " Update()
 "
 func! ctrlsf#Update() abort
@@ -79,6 +332,32 @@ func! ctrlsf#Redraw() abort
     call ctrlsf#win#MoveCursor(wlnum, lnum, col)
 endf
 
+" LoadVisibleContext()
+"
+" With 'g:ctrlsf_lazy_context', load context lines of paragraphs in sight and
+" redraw, keeping the same lines at top of window and under cursor.
+"
+func! ctrlsf#LoadVisibleContext() abort
+    " do not throw away changes in edit mode
+    if !g:ctrlsf_lazy_context || &l:modified
+        return
+    endif
+
+    let [wlnum, lnum, col] = [line('w0'), line('.'), col('.')]
+    let top    = ctrlsf#view#Reflect(wlnum)[1]
+    let cursor = ctrlsf#view#Reflect(lnum)[1]
+
+    if ctrlsf#db#LoadContext(wlnum, line('w$')) == 0
+        return
+    endif
+
+    call ctrlsf#win#Draw()
+    call ctrlsf#buf#ClearUndoHistory()
+    call ctrlsf#win#MoveCursor(
+        \ empty(top) ? wlnum : top.vlnum,
+        \ empty(cursor) ? lnum : cursor.vlnum, col)
+endf
+
 " Save()
 "
 func! ctrlsf#Save()
@@ -86,13 +365,19 @@ func! ctrlsf#Save()
         return
     endif
 
+    let indent   = ctrlsf#view#Indent()
     let changed  = ctrlsf#edit#Save()
 
     if changed > 0
         " DO NOT redraw if it is an undo (then seq_last != seq_cur)
         let undotree = undotree()
         if undotree.seq_last == undotree.seq_cur
-            call ctrlsf#Redraw()
+            " only patch lines of changed files unless width of line number
+            " column has changed
+            if indent != ctrlsf#view#Indent()
+                \ || ctrlsf#win#Patch(ctrlsf#edit#ChangedFiles()) == -1
+                call ctrlsf#Redraw()
+            endif
         endif
 
         " reset 'modified' flag
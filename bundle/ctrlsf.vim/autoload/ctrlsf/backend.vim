@@ -7,15 +7,26 @@
 
 " BuildCommand()
 "
-func! s:BuildCommand(args) abort
+" Search in {paths} if it is not empty, instead of paths given by options.
+" Files in {excludes} are skipped when searching in default root, which is
+" only possible for ag as ack can ignore files by name but not by path.
+"
+func! s:BuildCommand(args, paths, excludes) abort
     let tokens = []
+    let paths  = a:paths
+    if empty(paths) && ctrlsf#opt#IsOptGiven('changed')
+        let paths = sort(keys(ctrlsf#opt#GetOpt('_changed')))
+    endif
 
     " add executable file
     call add(tokens, g:ctrlsf_ackprg)
 
     " If user has specified '-A', '-B' or '-C', then use it without complaint
     " else use the default value 'g:ctrlsf_context'
-    let ctx_options = ctrlsf#opt#GetContext()
+    "
+    " With 'g:ctrlsf_lazy_context', search without context. Context lines are
+    " loaded later by ctrlsf#db#LoadContext().
+    let ctx_options = g:ctrlsf_lazy_context ? {} : ctrlsf#opt#GetContext()
     let context = ''
     for opt in keys(ctx_options)
         let context .= printf("--%s=%s ", opt, ctx_options[opt])
@@ -52,29 +63,58 @@ func! s:BuildCommand(args) abort
         call add(tokens, '--noheading --nogroup --nocolor --nobreak --nocolumn')
     endif
 
+    " like .gitignore, ag anchors an ignore pattern starting with '/' to the
+    " search root, otherwise a.txt would ignore a.txt in every directory
+    if empty(paths) && empty(ctrlsf#opt#GetOpt('path'))
+        \ && g:ctrlsf_ackprg =~# 'ag'
+        let root = fnamemodify(ctrlsf#backend#Root(), ':p')
+        for file in a:excludes
+            if stridx(file, root) == 0
+                call add(tokens, '--ignore ' . shellescape(file[len(root)-1:]))
+            endif
+        endfo
+    endif
+
+    " always print filename, even if only one file is given
+    if !empty(paths)
+        call add(tokens, g:ctrlsf_ackprg =~# 'ag' ? '--filename' : '--with-filename')
+    endif
+
     " pattern (including escape)
     call add(tokens, shellescape(ctrlsf#opt#GetOpt('pattern')))
 
     " path (including escape)
-    if !empty(ctrlsf#opt#GetOpt('path'))
+    if !empty(paths)
+        for path in paths
+            call add(tokens, shellescape(path))
+        endfo
+    elseif !empty(ctrlsf#opt#GetOpt('path'))
         for path in ctrlsf#opt#GetOpt('path')
             call add(tokens, shellescape(path))
         endfo
     else
-        let path = {
-            \ 'project' : ctrlsf#fs#FindVcsRoot(),
-            \ 'cwd'     : getcwd(),
-            \ }[g:ctrlsf_default_root]
-        " If project root is not found, use current file
-        if empty(path)
-            let path = expand('%:p')
-        endif
-        call add(tokens, path)
+        call add(tokens, ctrlsf#backend#Root())
     endif
 
     return join(tokens, ' ')
 endf
 
+" Root()
+"
+" Path to search in when no path is given.
+"
+func! ctrlsf#backend#Root() abort
+    let path = {
+        \ 'project' : ctrlsf#fs#FindVcsRoot(),
+        \ 'cwd'     : getcwd(),
+        \ }[g:ctrlsf_default_root]
+    " If project root is not found, use current file
+    if empty(path)
+        let path = expand('%:p')
+    endif
+    return path
+endf
+
 " SelfCheck()
 "
 func! ctrlsf#backend#SelfCheck() abort
@@ -119,13 +159,14 @@ endf
 " Execute Ack/Ag.
 "
 " Parameters
-" {args} arguments for execution
+" {args}  arguments for execution
+" [paths] list of paths to search in, instead of paths given by {args}
 "
 " Returns
 " [success/fail, output]
 "
-func! ctrlsf#backend#Run(args) abort
-    let command = s:BuildCommand(a:args)
+func! ctrlsf#backend#Run(args, ...) abort
+    let command = s:BuildCommand(a:args, get(a:000, 0, []), [])
     call ctrlsf#log#Debug("ExecCommand: %s", command)
 
     " A windows user reports CtrlSF doesn't work well when 'shelltemp' is
@@ -142,3 +183,84 @@ func! ctrlsf#backend#Run(args) abort
         return [1, output]
     endif
 endf
+
+" RunAsync()
+"
+" Execute Ack/Ag in background.
+"
+" Parameters
+" {args}     arguments for execution
+" {callback} function called with [success/fail, output] when search is done,
+"            unless it is stopped by Stop() before
+" [paths]    list of paths to search in, instead of paths given by {args}
+" [excludes] list of absolute paths of files not to search in, see
+"            s:BuildCommand()
+"
+" Returns
+" a handle to pass to Stop(), or {} if jobs are not supported
+"
+func! ctrlsf#backend#RunAsync(args, callback, ...) abort
+    if !has('job')
+        return {}
+    endif
+
+    let command = s:BuildCommand(a:args, get(a:000, 0, []), get(a:000, 1, []))
+    call ctrlsf#log#Debug("ExecCommandAsync: %s", command)
+
+    let handle = {
+        \ 'lines'    : [],
+        \ 'stopped'  : 0,
+        \ 'callback' : a:callback,
+        \ }
+    let handle.job = job_start([&shell, &shellcmdflag, command], {
+        \ 'in_io'    : 'null',
+        \ 'err_io'   : 'out',
+        \ 'out_cb'   : function('s:OnOutput', [handle]),
+        \ 'close_cb' : function('s:OnClose', [handle]),
+        \ 'exit_cb'  : function('s:OnExit', [handle]),
+        \ })
+
+    return handle
+endf
+
+" Stop()
+"
+" Stop a search started by RunAsync(). Its callback won't be called.
+"
+func! ctrlsf#backend#Stop(handle) abort
+    if empty(a:handle)
+        return
+    endif
+
+    let a:handle.stopped = 1
+    if job_status(a:handle.job) ==# 'run'
+        call job_stop(a:handle.job)
+    endif
+endf
+
+func! s:OnOutput(handle, channel, msg) abort
+    call add(a:handle.lines, a:msg)
+endf
+
+" output is read completely when channel is closed, but exit status may come
+" before or after that
+func! s:OnClose(handle, channel) abort
+    let a:handle.closed = 1
+    call s:Done(a:handle)
+endf
+
+func! s:OnExit(handle, job, status) abort
+    let a:handle.exitval = a:status
+    call s:Done(a:handle)
+endf
+
+func! s:Done(handle) abort
+    if a:handle.stopped || !has_key(a:handle, 'closed')
+        \ || !has_key(a:handle, 'exitval')
+        return
+    endif
+
+    let output = join(a:handle.lines, "\n")
+    let failed = a:handle.exitval && !empty(output)
+    call a:handle.callback(!failed, output)
+endf
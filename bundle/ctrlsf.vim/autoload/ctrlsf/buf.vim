@@ -19,6 +19,29 @@ func! ctrlsf#buf#WriteString(content) abort
     call setbufvar('%', '&modified', 0)
 endf
 
+" SetLines()
+"
+" Replace lines of current buffer with {lines}, a list of [lnum, content].
+" Only lines which differ are touched.
+"
+" Returns
+" number of lines replaced
+"
+func! ctrlsf#buf#SetLines(lines) abort
+    let modifiable_bak = getbufvar('%', '&modifiable')
+    setl modifiable
+    let replaced = 0
+    for [lnum, content] in a:lines
+        if getline(lnum) !=# content
+            call setline(lnum, content)
+            let replaced += 1
+        endif
+    endfo
+    call setbufvar('%', '&modifiable', modifiable_bak)
+    call setbufvar('%', '&modified', 0)
+    return replaced
+endf
+
 " WriteFile()
 "
 " Write (or read?) {file} to current buffer.
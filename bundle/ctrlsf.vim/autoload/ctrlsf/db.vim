@@ -138,6 +138,7 @@ func! s:NewParagraph(buffer) abort
         \ 'range'   : function("ctrlsf#class#paragraph#Range"),
         \ 'lines'   : [],
         \ 'matches' : function("ctrlsf#class#paragraph#Matches"),
+        \ 'lazy'    : g:ctrlsf_lazy_context,
         \ }
 
     for [fname, lnum, content] in a:buffer
@@ -154,24 +155,24 @@ func! s:NewParagraph(buffer) abort
         endif
 
         " add line content
-        call add(paragraph.lines, {
+        call add(paragraph.lines, s:Truncate({
             \ 'matched' : function("ctrlsf#class#line#Matched"),
             \ 'match'   : match,
             \ 'lnum'    : lnum,
             \ 'vlnum'   : -1,
             \ 'content' : content,
-            \ })
+            \ }))
     endfo
 
     return paragraph
 endf
 
-" ParseAckprgResult()
+" s:ParseResult()
 "
-func! ctrlsf#db#ParseAckprgResult(result) abort
-    " reset
-    let s:resultset = []
-    call ctrlsf#db#ClearCache()
+" Parse output of backend into a list of paragraphs.
+"
+func! s:ParseResult(result) abort
+    let resultset = []
 
     " in case of mixed text from win-style files and unix-style files, breaks
     " result into lines by both <CR><NL> and <NL>.
@@ -213,11 +214,383 @@ func! ctrlsf#db#ParseAckprgResult(result) abort
 
         if len(buffer) > 0
             let paragraph = s:NewParagraph(buffer)
-            call add(s:resultset, paragraph)
+            call add(resultset, paragraph)
         endif
 
         let current_file = next_file
     endwh
+
+    return resultset
+endf
+
+" ParseAckprgResult()
+"
+func! ctrlsf#db#ParseAckprgResult(result) abort
+    let s:resultset = s:ParseResult(a:result)
+    call ctrlsf#db#ClearCache()
+
+    if ctrlsf#opt#IsOptGiven('changed') && g:ctrlsf_changed_hunks
+        call ctrlsf#db#FilterRanges(ctrlsf#opt#GetOpt('_changed'))
+    endif
+endf
+
+" AppendAckprgResult()
+"
+" Append paragraphs in {result} to resultset, except those of files already
+" in it, so that what is in resultset stays unchanged.
+"
+" Returns
+" number of paragraphs appended
+"
+func! ctrlsf#db#AppendAckprgResult(result) abort
+    let known = {}
+    for file in uniq(map(copy(s:resultset), 'v:val.file'))
+        let known[simplify(fnamemodify(file, ':p'))] = 1
+    endfo
+
+    let paragraphs = []
+    let [file, skip] = ['', 0]
+    for par in s:ParseResult(a:result)
+        if par.file !=# file
+            let file = par.file
+            let skip = has_key(known, simplify(fnamemodify(file, ':p')))
+        endif
+        if !skip
+            call add(paragraphs, par)
+        endif
+    endfo
+
+    call extend(s:resultset, paragraphs)
+    call ctrlsf#db#ClearCache()
+    return len(paragraphs)
+endf
+
+" SortByFiles()
+"
+" Stable sort resultset by order of files in {files}. Files not in {files}
+" go last.
+"
+func! ctrlsf#db#SortByFiles(files) abort
+    let s:file_rank = {}
+    for i in range(len(a:files))
+        let s:file_rank[a:files[i]] = i + 1
+    endfo
+
+    call sort(s:resultset, 's:CompareFileRank')
+    unlet s:file_rank
+    call ctrlsf#db#ClearCache()
+endf
+
+func! s:CompareFileRank(a, b) abort
+    let rank_a = get(s:file_rank, a:a.file, len(s:file_rank) + 1)
+    let rank_b = get(s:file_rank, a:b.file, len(s:file_rank) + 1)
+    return rank_a - rank_b
+endf
+
+" FilterRanges()
+"
+" Drop matches out of {ranges}, which is a dict of file => list of [first,
+" last]. Lines beyond context of remaining matches are dropped too, so a
+" paragraph may be split into several or removed entirely.
+"
+func! ctrlsf#db#FilterRanges(ranges) abort
+    let [before, after] = s:ContextSize()
+    let resultset = []
+
+    for par in s:resultset
+        let ranges = get(a:ranges, par.file, [])
+        for line in par.lines
+            if line.matched() && empty(filter(copy(ranges),
+                \ 'v:val[0] <= line.lnum && line.lnum <= v:val[1]'))
+                let line.match = {}
+            endif
+        endfo
+        call extend(resultset, s:Split(par, before, after))
+    endfo
+
+    let s:resultset = resultset
+    call ctrlsf#db#ClearCache()
+endf
+
+" s:Split()
+"
+" Split {par} into pieces around its matched lines, dropping lines which are
+" not within {before}/{after} lines of any match.
+"
+func! s:Split(par, before, after) abort
+    let kept = map(a:par.matches(), 'v:val.lnum')
+    let pieces = []
+    let lines  = []
+    for line in a:par.lines
+        if empty(filter(copy(kept),
+            \ 'v:val - a:before <= line.lnum && line.lnum <= v:val + a:after'))
+            if !empty(lines)
+                call add(pieces, extend(copy(a:par), {'lines': lines}))
+                let lines = []
+            endif
+        else
+            call add(lines, line)
+        endif
+    endfo
+    if !empty(lines)
+        call add(pieces, extend(copy(a:par), {'lines': lines}))
+    endif
+    return pieces
+endf
+
+"""""""""""""""""""""""""""""""""
+" Truncation
+"""""""""""""""""""""""""""""""""
+let s:ELLIPSIS = '...'
+
+" s:Truncate()
+"
+" Cut content of {line} down to 'g:ctrlsf_truncate_width' bytes around its
+" match, or to its head if it doesn't match, so that a huge line (think of
+" minified files) doesn't slow down rendering and highlighting. Removed parts
+" are replaced by ellipses, and [head, tail] byte offsets of what is kept are
+" stored in 'trunc'. Full line is not kept; it's read from file when needed.
+"
+" Note that column of match still counts from the start of full line.
+"
+func! s:Truncate(line) abort
+    let width   = g:ctrlsf_truncate_width
+    let content = a:line.content
+    if width <= 0 || strlen(content) <= width
+        return a:line
+    endif
+
+    " leave a quarter of width before the match
+    let head = a:line.matched() ? max([a:line.match.col - 1 - width / 4, 0]) : 0
+    let head = s:CharStart(content, head)
+    let tail = head + width
+    let tail = tail >= strlen(content) ? strlen(content) :
+        \ s:CharStart(content, tail)
+
+    let a:line.content = ctrlsf#db#Cut(content, head, tail)
+    let a:line.trunc   = [head, tail]
+    return a:line
+endf
+
+" s:CharStart()
+"
+" Return byte offset of the character which byte {byte} of {content} is part
+" of. charidx() is only in Vim 8.2.2233 and later; the fallback matches the
+" first character ending after {byte}.
+"
+func! s:CharStart(content, byte) abort
+    if exists('*charidx')
+        return byteidx(a:content, charidx(a:content, a:byte))
+    endif
+    return a:byte > 0 ? match(a:content, '\m.\%>' . (a:byte + 1) . 'c') : 0
+endf
+
+" Cut()
+"
+" Return bytes {head} to {tail} of {content} wrapped with ellipses, in the
+" same form as content of a truncated line.
+"
+func! ctrlsf#db#Cut(content, head, tail) abort
+    return (a:head > 0 ? s:ELLIPSIS : '')
+        \ . strpart(a:content, a:head, a:tail - a:head)
+        \ . (a:tail < strlen(a:content) ? s:ELLIPSIS : '')
+endf
+
+" Shift()
+"
+" Return offset between column of {line} in file and column in its content.
+"
+func! ctrlsf#db#Shift(line) abort
+    if !has_key(a:line, 'trunc') || a:line.trunc[0] == 0
+        return 0
+    endif
+    return strlen(s:ELLIPSIS) - a:line.trunc[0]
+endf
+
+"""""""""""""""""""""""""""""""""
+" Lazy Context
+"""""""""""""""""""""""""""""""""
+" s:ContextSize()
+"
+" Return [before, after] of current context options.
+"
+func! s:ContextSize() abort
+    let ctx = ctrlsf#opt#GetContext()
+    let context = str2nr(get(ctx, 'context', 0))
+    return [str2nr(get(ctx, 'before', context)),
+        \ str2nr(get(ctx, 'after', context))]
+endf
+
+" s:Extent()
+"
+" Return [first, last] line number a paragraph occupies once its context is
+" loaded.
+"
+func! s:Extent(par, before, after) abort
+    let [first, last] = [str2nr(a:par.lnum()),
+        \ str2nr(a:par.lnum()) + a:par.range() - 1]
+    if get(a:par, 'lazy', 0)
+        let [first, last] = [max([first - a:before, 1]), last + a:after]
+    endif
+    return [first, last]
+endf
+
+" s:FileLines()
+"
+" Return lines {first} to {last} of {file}, from buffer if it is loaded.
+"
+func! s:FileLines(file, first, last) abort
+    let bufnr = bufnr(a:file)
+    if bufnr != -1 && bufloaded(bufnr)
+        return getbufline(bufnr, a:first, a:last)
+    endif
+
+    try
+        return readfile(a:file, '', a:last)[a:first - 1 :]
+    catch
+        call ctrlsf#log#Error("Failed to open file %s", a:file)
+        return []
+    endtry
+endf
+
+" s:LoadParagraph()
+"
+" Load context of paragraph {idx}. Like what Ack/Ag does with context, it is
+" merged with its neighbours if their context overlaps or adjoins.
+"
+" Returns
+" index of the merged paragraph, or -1 if nothing is loaded
+"
+func! s:LoadParagraph(idx, before, after) abort
+    let par = s:resultset[a:idx]
+    let [first, last] = s:Extent(par, a:before, a:after)
+
+    " find neighbours to merge
+    let [i, j] = [a:idx, a:idx]
+    while i > 0 && s:resultset[i - 1].file ==# par.file
+        \ && s:Extent(s:resultset[i - 1], a:before, a:after)[1] >= first - 1
+        let i -= 1
+        let first = min([first, s:Extent(s:resultset[i], a:before, a:after)[0]])
+    endwh
+    while j < len(s:resultset) - 1 && s:resultset[j + 1].file ==# par.file
+        \ && s:Extent(s:resultset[j + 1], a:before, a:after)[0] <= last + 1
+        let j += 1
+        let last = max([last, s:Extent(s:resultset[j], a:before, a:after)[1]])
+    endwh
+
+    " line objects already in resultset
+    let known = {}
+    for merged in s:resultset[i : j]
+        for line in merged.lines
+            let known[line.lnum] = line
+        endfo
+    endfo
+
+    let contents = s:FileLines(par.file, first, last)
+    let lines = []
+    for k in range(len(contents))
+        let lnum = first + k
+        if has_key(known, lnum)
+            call add(lines, known[lnum])
+        else
+            call add(lines, s:Truncate({
+                \ 'matched' : function("ctrlsf#class#line#Matched"),
+                \ 'match'   : {},
+                \ 'lnum'    : lnum,
+                \ 'vlnum'   : -1,
+                \ 'content' : contents[k],
+                \ }))
+        endif
+    endfo
+
+    " file has been changed since searching, keep what we have
+    if empty(lines)
+        return -1
+    endif
+
+    let merged = s:resultset[i]
+    let merged.lines = lines
+    let merged.lazy  = 0
+    if j > i
+        call remove(s:resultset, i + 1, j)
+    endif
+
+    return i
+endf
+
+" LoadContext()
+"
+" Load context lines of paragraphs which are rendered between view line
+" {first} and {last}.
+"
+" Returns
+" number of paragraphs loaded
+"
+func! ctrlsf#db#LoadContext(first, last) abort
+    let [before, after] = s:ContextSize()
+    let loaded = 0
+
+    let idx = 0
+    while idx < len(s:resultset)
+        let par = s:resultset[idx]
+        if par.vlnum() > a:last
+            break
+        endif
+
+        if get(par, 'lazy', 0) && par.vlnum() + par.range() - 1 >= a:first
+            let merged = s:LoadParagraph(idx, before, after)
+            if merged != -1
+                let loaded += 1
+                let idx = merged
+            endif
+        endif
+        let idx += 1
+    endwh
+
+    if loaded > 0
+        call ctrlsf#db#ClearCache()
+    endif
+
+    return loaded
+endf
+
+" Narrow()
+"
+" Narrow resultset down to current pattern, which must be an extension of the
+" pattern resultset is searched with, so that every new match is already a
+" matched line in resultset. Paragraphs are rebuilt around the remaining
+" matches with current context, see s:Split().
+"
+func! ctrlsf#db#Narrow() abort
+    let regex = ctrlsf#opt#GetOpt("_vimregex")
+    let [before, after] = s:ContextSize()
+    let resultset = []
+
+    for par in s:resultset
+        for line in par.lines
+            if line.matched()
+                " new match may be in the part truncated away
+                let content = has_key(line, 'trunc') ?
+                    \ get(s:FileLines(par.file, line.lnum, line.lnum), 0, '') :
+                    \ line.content
+                let mat_col = match(content, regex) + 1
+                if mat_col > 0
+                    let line.match.col = mat_col
+                    if has_key(line, 'trunc')
+                        let line.content = content
+                        call remove(line, 'trunc')
+                        call s:Truncate(line)
+                    endif
+                else
+                    let line.match = {}
+                endif
+            endif
+        endfo
+        call extend(resultset, s:Split(par, before, after))
+    endfo
+
+    let s:resultset = resultset
+    call ctrlsf#db#ClearCache()
 endf
 
 """""""""""""""""""""""""""""""""
@@ -228,3 +601,24 @@ endf
 func! ctrlsf#db#ClearCache() abort
     let s:cache = {}
 endf
+
+"""""""""""""""""""""""""""""""""
+" Memory
+"""""""""""""""""""""""""""""""""
+" MemoryUsage()
+"
+" Return number of entries and approximate size in bytes of resultset and
+" cache.
+"
+func! ctrlsf#db#MemoryUsage() abort
+    return {
+        \ 'resultset': {
+        \   'entries': len(s:resultset),
+        \   'bytes'  : len(string(s:resultset)),
+        \ },
+        \ 'cache': {
+        \   'entries': len(s:cache),
+        \   'bytes'  : len(string(s:cache)),
+        \ },
+        \ }
+endf
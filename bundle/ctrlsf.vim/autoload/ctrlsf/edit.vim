@@ -5,6 +5,9 @@
 " Version: 1.20
 " ============================================================================
 
+" files changed in the last Save()
+let s:changed_files = []
+
 " s:DiffFile()
 "
 func! s:DiffFile(orig, modi) abort
@@ -64,28 +67,64 @@ func! s:Diff(orig, modi) abort
     return changed_files
 endf
 
-" s:VerifyConsistent()
+" s:MatchParagraph()
 "
-" Check if a file in resultset is different from its disk counterpart.
+" Check if lines of {par} in resultset are found in {buffer} starting at
+" {lnum}.
 "
-func! s:VerifyConsistent(on_disk, on_mem)
-    for par in a:on_mem.paragraphs
-        for i in range(par.range())
-            let ln = par.lnum() + i
-            let line = par.lines[i]
+func! s:MatchParagraph(buffer, par, lnum) abort
+    if a:lnum < 1 || a:lnum + a:par.range() - 1 > len(a:buffer)
+        return 0
+    endif
 
-            if line.content !=# a:on_disk[ln-1]
-                call ctrlsf#log#Debug("InconsistentContent: [Lnum]: %d,
-                            \ [FileInMem]: %s, [FileOnDisk]: %s",
-                            \ ln, line.content, a:on_disk[ln-1])
-                return 0
-            endif
-        endfo
+    for i in range(a:par.range())
+        let line = a:par.lines[i]
+        let content = a:buffer[a:lnum + i - 1]
+        if has_key(line, 'trunc')
+            let content = ctrlsf#db#Cut(content, line.trunc[0], line.trunc[1])
+        endif
+
+        if line.content !=# content
+            return 0
+        endif
     endfo
 
     return 1
 endf
 
+" s:Anchor()
+"
+" Return line number where paragraph {par} is found in {buffer} now. Try
+" {expected} first, then look for the paragraph within
+" g:ctrlsf_anchor_range lines around it but not above {floor}. Return -1 if
+" the paragraph is not found or found at more than one place.
+"
+func! s:Anchor(buffer, par, expected, floor) abort
+    if a:expected >= a:floor && s:MatchParagraph(a:buffer, a:par, a:expected)
+        return a:expected
+    endif
+
+    let first = max([a:floor, a:expected - g:ctrlsf_anchor_range])
+    let last  = min([len(a:buffer) - a:par.range() + 1,
+        \ a:expected + g:ctrlsf_anchor_range])
+    let head  = a:par.range() > 0 && !has_key(a:par.lines[0], 'trunc')
+        \ ? a:par.lines[0].content : ''
+
+    let found = []
+    let lnum = first
+    while lnum <= last && len(found) < 2
+        if (head ==# '' || a:buffer[lnum-1] ==# head)
+            \ && s:MatchParagraph(a:buffer, a:par, lnum)
+            call add(found, lnum)
+        endif
+        let lnum += 1
+    endwh
+
+    call ctrlsf#log#Debug("Anchor: [Lnum]: %d, [Found]: %s",
+        \ a:par.lnum(), string(found))
+    return len(found) == 1 ? found[0] : -1
+endf
+
 " s:WriteParagraph()
 "
 " Function which does two things:
@@ -93,7 +132,9 @@ endf
 " 1. modify, insert or/and delete lines in buffer
 " 2. update resultset to represent modified content
 "
-func! s:WriteParagraph(buffer, orig, modi, offset)
+" {drift} is how far the paragraph has moved in file since last search.
+"
+func! s:WriteParagraph(buffer, orig, modi, offset, drift)
     let orig_count  = a:orig.range()
     let modi_count  = a:modi.range()
     let start_lnum  = a:orig.lnum()
@@ -101,9 +142,19 @@ func! s:WriteParagraph(buffer, orig, modi, offset)
 
     for i in range(modi_count)
         let mline = a:modi.lines[i]
-        let ln    = start_lnum + i + a:offset
+        let ln    = start_lnum + i + a:offset + a:drift
         let vln   = start_vlnum + i + a:offset
 
+        " truncated line is left as it is in file, see s:EditedTruncated()
+        if i < orig_count && has_key(a:orig.lines[i], 'trunc')
+            let line_obj = a:orig.lines[i]
+            let [line_obj.lnum, line_obj.vlnum] = [ln, vln]
+            if line_obj.matched()
+                let [line_obj.match.lnum, line_obj.match.vlnum] = [ln, vln]
+            endif
+            continue
+        endif
+
         " create new line object
         let line_obj = {
             \ 'matched' : function("ctrlsf#class#line#Matched"),
@@ -137,7 +188,7 @@ func! s:WriteParagraph(buffer, orig, modi, offset)
     " remove deleted lines from paragraph
     if orig_count > modi_count
         for i in range(orig_count-1, modi_count, -1)
-            let ln = start_lnum + i + a:offset
+            let ln = start_lnum + i + a:offset + a:drift
             call remove(a:orig.lines, i)
             call remove(a:buffer, ln-1)
         endfo
@@ -146,8 +197,41 @@ func! s:WriteParagraph(buffer, orig, modi, offset)
     return modi_count - orig_count
 endf
 
+" s:EditedTruncated()
+"
+" Return line number of the first truncated line which is modified or
+" deleted in {modi}, or 0 if there is none. A truncated line can't be
+" written back because only part of it is in the view.
+"
+func! s:EditedTruncated(orig, modi) abort
+    let i = 0
+    while i < len(a:orig.paragraphs)
+        let opar = a:orig.paragraphs[i]
+        let mpar = a:modi.paragraphs[i]
+        let i += 1
+
+        for j in range(opar.range())
+            let line = opar.lines[j]
+            if has_key(line, 'trunc') && (j >= mpar.range()
+                \ || mpar.lines[j].content !=# line.content)
+                return line.lnum
+            endif
+        endfo
+    endwh
+
+    return 0
+endf
+
 " s:SaveFile()
 "
+" Paragraphs are re-anchored in case file is changed after searching, see
+" s:Anchor(). Changed paragraphs which can't be anchored are skipped and
+" marked as 'stale', as their content in resultset is out of date.
+"
+" Returns
+" [written, skipped] number of paragraphs written and skipped, written is -1
+"                    if file can't be read or written
+"
 func! s:SaveFile(orig, modi) abort
     let file = a:orig.file
 
@@ -155,28 +239,47 @@ func! s:SaveFile(orig, modi) abort
         let buffer = readfile(file)
     catch
         call ctrlsf#log#Error("Failed to open file %s", file)
-        return -1
+        return [-1, 0]
     endtry
 
-    " if file is changed after searching thus shows differences against
-    " resultset, skip writing and warn user.
-    if !s:VerifyConsistent(buffer, a:orig)
-        call ctrlsf#log#Error("File %s has been changed since last search. Skip
-            \ this file. Please run :CtrlsfUpdate to update your search result."
-            \ , file)
-        return -1
-    endif
-
+    let [written, skipped] = [0, 0]
     let i = 0
     let offset = 0
+    let drift  = 0
+    let floor  = 1
     while i < len(a:orig.paragraphs)
         let opar = a:orig.paragraphs[i]
         let mpar = a:modi.paragraphs[i]
         let i += 1
 
-        let offset += s:WriteParagraph(buffer, opar, mpar, offset)
+        let changed = s:DiffFile({'file': file, 'paragraphs': [opar]},
+            \ {'file': file, 'paragraphs': [mpar]})
+        let lnum = s:Anchor(buffer, opar, opar.lnum() + offset + drift, floor)
+
+        " if file is changed after searching and the paragraph can't be
+        " located in it any more, skip writing and warn user.
+        if lnum == -1
+            if changed
+                call ctrlsf#log#Error("Line %s of %s can't be located since the
+                    \ file has been changed after last search. Skip this
+                    \ paragraph. Please run :CtrlSFUpdate to update your search
+                    \ result.", opar.lnum(), file)
+                let skipped += 1
+                let opar.stale = 1
+            endif
+            continue
+        endif
+
+        let drift   = lnum - opar.lnum() - offset
+        let offset += s:WriteParagraph(buffer, opar, mpar, offset, drift)
+        let floor   = lnum + mpar.range()
+        let written += changed
     endwh
 
+    if written == 0
+        return [0, skipped]
+    endif
+
     " append <CR> to each line when file's format is 'dos'
     if ctrlsf#fs#DetectFileFormat(file) == 'dos'
         for i in range(len(buffer))
@@ -186,14 +289,17 @@ func! s:SaveFile(orig, modi) abort
 
     if writefile(buffer, file) == -1
         call ctrlsf#log#Error("Failed to write file %s", file)
-    else
-        call ctrlsf#log#Debug("WritingFile: %s succeed.", file)
+        return [-1, skipped]
     endif
+    call ctrlsf#log#Debug("WritingFile: %s succeed.", file)
+
+    return [written, skipped]
 endf
 
 " Save()
 "
 func! ctrlsf#edit#Save()
+    let s:changed_files = []
     let orig = ctrlsf#db#FileSet()
     let modi = ctrlsf#view#Derender(getline(0, '$'))
 
@@ -209,6 +315,18 @@ func! ctrlsf#edit#Save()
         return -1
     endtry
 
+    for file in changed
+        let lnum = s:EditedTruncated(file.orig, file.modi)
+        if lnum > 0
+            call ctrlsf#log#Error("Line %s of %s is truncated and can't be
+                \ edited here. Please undo the change and edit it in the file."
+                \ , lnum, file.orig.file)
+            return -1
+        endif
+    endfo
+
+    let s:changed_files = map(copy(changed), 'v:val.orig.file')
+
     " prompt to confirm save
     if g:ctrlsf_confirm_save
         let mes = printf("%s files will be saved. Confirm? (Y/n)", len(changed))
@@ -224,20 +342,36 @@ func! ctrlsf#edit#Save()
         return -1
     endif
 
-    let [saved, skipped] = [0, 0]
+    let [saved, skipped, conflicts] = [0, 0, 0]
     for file in changed
-        if s:SaveFile(file.orig, file.modi) > -1
+        let [written, paragraphs] = s:SaveFile(file.orig, file.modi)
+        let conflicts += paragraphs
+        if written > 0
             let saved += 1
         else
             let skipped += 1
         endif
     endfo
 
-    if skipped == 0
+    " max line number may have changed, which is cached while writing
+    call ctrlsf#db#ClearCache()
+
+    if skipped == 0 && conflicts == 0
         call ctrlsf#log#Info("%s files are saved.", saved)
-    else
+    elseif conflicts == 0
         call ctrlsf#log#Info("%s files are saved (%s skipped).", saved, skipped)
+    else
+        call ctrlsf#log#Info("%s files are saved (%s skipped, %s paragraphs
+            \ skipped).", saved, skipped, conflicts)
     endif
 
     return len(changed)
 endf
+
+" ChangedFiles()
+"
+" Return list of files changed in the last Save(), including skipped ones.
+"
+func! ctrlsf#edit#ChangedFiles()
+    return s:changed_files
+endf
@@ -25,6 +25,48 @@ func! ctrlsf#fs#FindVcsRoot() abort
     return root
 endf
 
+" RecentFiles()
+"
+" Return files under {root} which user is likely to care about: loaded
+" buffers (most recently used first), files modified in git working tree and
+" files in 'v:oldfiles', at most {limit} ones.
+"
+func! ctrlsf#fs#RecentFiles(root, limit) abort
+    let candidates = []
+
+    let buffers = filter(getbufinfo({'buflisted': 1, 'bufloaded': 1}),
+        \ 'empty(getbufvar(v:val.bufnr, "&buftype"))')
+    call sort(buffers, 's:CompareLastUsed')
+    call extend(candidates, map(buffers, 'v:val.name'))
+
+    call extend(candidates, sort(ctrlsf#git#ChangedFiles()))
+
+    call extend(candidates, copy(v:oldfiles))
+
+    let root  = fnamemodify(a:root, ':p')
+    let files = []
+    let seen  = {}
+    for file in candidates
+        let file = simplify(fnamemodify(file, ':p'))
+        if has_key(seen, file) || stridx(file, root) != 0
+            \ || !filereadable(file)
+            continue
+        endif
+        let seen[file] = 1
+        call add(files, file)
+        if len(files) >= a:limit
+            break
+        endif
+    endfo
+
+    call ctrlsf#log#Debug("RecentFiles: %s", string(files))
+    return files
+endf
+
+func! s:CompareLastUsed(a, b) abort
+    return get(a:b, 'lastused', 0) - get(a:a, 'lastused', 0)
+endf
+
 " DetectFileFormat
 "
 " Determine file's format by <EOL>.
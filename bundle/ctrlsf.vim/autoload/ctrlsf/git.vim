@@ -0,0 +1,179 @@
+" ============================================================================
+" Description: An ack/ag powered code search and view tool.
+" Author: Ye Ding <dygvirus@gmail.com>
+" Licence: Vim licence
+" Version: 1.20
+" ============================================================================
+
+" s:Git()
+"
+" Run git with {args} in current working directory.
+"
+" Returns
+" [success/fail, output]
+"
+func! s:Git(args) abort
+    let output = system('git ' . a:args)
+    return [!v:shell_error, output]
+endf
+
+" IsRevision()
+"
+func! ctrlsf#git#IsRevision(rev) abort
+    if !executable('git')
+        return 0
+    endif
+    return s:Git('rev-parse --verify --quiet '
+        \ . shellescape(a:rev . '^{commit}'))[0]
+endf
+
+" s:Unquote()
+"
+" Git quotes a path containing '"', '\' or control characters like a C
+" string. Non-ASCII characters are kept as they are with core.quotepath off.
+"
+let s:escapes = {'a': "\x07", 'b': "\b", 't': "\t", 'n': "\n", 'v': "\x0b",
+    \ 'f': "\f", 'r': "\r", '"': '"', '\': '\'}
+
+func! s:Unquote(path) abort
+    if a:path !~# '^".*"$'
+        return a:path
+    endif
+    return substitute(a:path[1:-2], '\\\(\o\o\o\|.\)',
+        \ '\=len(submatch(1)) == 3 ? eval(''"\'' . submatch(1) . ''"'')
+        \ : get(s:escapes, submatch(1), submatch(1))', 'g')
+endf
+
+" s:ParseHunks()
+"
+" Parse output of 'git diff -U0' into a dict, in which key is path relative
+" to repository root and value is a list of [first, last] of changed lines.
+"
+func! s:ParseHunks(diff) abort
+    let hunks = {}
+    let file  = ''
+
+    for line in split(a:diff, '\n')
+        if line =~# '^+++ '
+            " a path with space is followed by a tab, which is quoted
+            " otherwise
+            let file = s:Unquote(substitute(line[4:], '\t$', '', ''))
+            let file = substitute(file, '^b/', '', '')
+            let hunks[file] = []
+        elseif line =~# '^@@ ' && !empty(file)
+            let [start, cnt] = matchlist(line,
+                \ '^@@ -\S\+ +\(\d\+\)\%(,\(\d\+\)\)\= @@')[1:2]
+            let cnt = empty(cnt) ? 1 : str2nr(cnt)
+            " pure deletion has no line in new file
+            if cnt > 0
+                call add(hunks[file], [str2nr(start), str2nr(start) + cnt - 1])
+            endif
+        endif
+    endfo
+
+    return hunks
+endf
+
+" Changes()
+"
+" Ask git for files changed since merge base of {base} and HEAD, including
+" uncommitted changes and untracked files.
+"
+" Returns
+" dict of absolute path => list of [first, last] of changed lines, or -1 if
+" git fails
+"
+func! ctrlsf#git#Changes(base) abort
+    if !executable('git')
+        call ctrlsf#log#Error("Can not locate git in PATH.")
+        return -1
+    endif
+
+    let [success, root] = s:Git('rev-parse --show-toplevel')
+    if !success
+        call ctrlsf#log#Error("Current directory is not in a git repository.")
+        return -1
+    endif
+    let root = substitute(root, '\n$', '', '')
+
+    let [success, merge_base] = s:Git('merge-base '
+        \ . shellescape(a:base) . ' HEAD')
+    if !success
+        call ctrlsf#log#Error("Can not find merge base of %s and HEAD.", a:base)
+        return -1
+    endif
+    let merge_base = substitute(merge_base, '\n$', '', '')
+
+    " prefixes may be changed by diff.noprefix or diff.mnemonicPrefix
+    let [success, diff] = s:Git('-C ' . shellescape(root)
+        \ . ' -c core.quotepath=off diff -U0 --no-color --no-ext-diff'
+        \ . ' --diff-filter=d --src-prefix=a/ --dst-prefix=b/ '
+        \ . merge_base)
+    if !success
+        call ctrlsf#log#Error("Failed to call git diff: %s", diff)
+        return -1
+    endif
+
+    let changes = {}
+    let hunks = s:ParseHunks(diff)
+    for file in keys(hunks)
+        let changes[root . '/' . file] = hunks[file]
+    endfo
+
+    " untracked files are changed entirely
+    let [success, untracked] = s:Git('-C ' . shellescape(root)
+        \ . ' ls-files -z --others --exclude-standard')
+    if success
+        for file in split(untracked, "\x01")
+            let changes[root . '/' . file] = [[1, 2147483647]]
+        endfo
+    endif
+
+    call ctrlsf#log#Debug("ChangedFiles: %s", string(changes))
+    return changes
+endf
+
+" ChangedFiles()
+"
+" Ask git for files which are modified, staged or untracked in working tree.
+" It is cheaper than Changes() as no diff is computed and it fails silently.
+"
+" Returns
+" list of absolute paths, or [] if not in a git repository
+"
+func! ctrlsf#git#ChangedFiles() abort
+    if !executable('git')
+        return []
+    endif
+
+    let [success, root] = s:Git('rev-parse --show-toplevel')
+    if !success
+        return []
+    endif
+    let root = substitute(root, '\n$', '', '')
+
+    " NUL separated entries are read as "\x01" by system(), names are not
+    " quoted with -z. A rename is followed by an entry of its original name.
+    let [success, status] = s:Git('-C ' . shellescape(root)
+        \ . ' status --porcelain -z --untracked-files=all')
+    if !success
+        return []
+    endif
+
+    let files = []
+    let entries = split(status, "\x01")
+    let i = 0
+    while i < len(entries)
+        let entry = entries[i]
+        let i += 1
+        if entry[0] =~# '[RC]'
+            let i += 1
+        endif
+        if entry[0:1] !~# 'D'
+            call add(files, root . '/' . entry[3:])
+        endif
+    endwh
+
+    call ctrlsf#log#Debug("ChangedFiles: %s", string(files))
+    return files
+endf
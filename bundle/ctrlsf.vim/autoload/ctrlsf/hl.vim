@@ -33,3 +33,32 @@ endf
 func! ctrlsf#hl#ClearSelectedLine() abort
     silent! call matchdelete(b:ctrlsf_highlight_id)
 endf
+
+" HighlightStale()
+"
+" Highlight lines of paragraphs which are skipped when saving, see
+" s:SaveFile() in edit.vim. Their content is older than the file.
+"
+func! ctrlsf#hl#HighlightStale() abort
+    for id in get(b:, 'ctrlsf_stale_ids', [])
+        silent! call matchdelete(id)
+    endfo
+    let b:ctrlsf_stale_ids = []
+
+    if !exists('b:current_syntax') || b:current_syntax !~# 'ctrlsf'
+        return -1
+    endif
+
+    let lnums = []
+    for par in ctrlsf#db#ResultSet()
+        if get(par, 'stale', 0)
+            call extend(lnums, map(copy(par.lines), 'v:val.vlnum'))
+        endif
+    endfo
+
+    " matchaddpos() accepts at most 8 positions at once in older Vim
+    while !empty(lnums)
+        let pos = remove(lnums, 0, min([7, len(lnums) - 1]))
+        call add(b:ctrlsf_stale_ids, matchaddpos('ctrlsfStale', pos, -1))
+    endwh
+endf
@@ -9,6 +9,7 @@
 let s:option_list = {
     \ '-after'      : {'args': 1},
     \ '-before'     : {'args': 1},
+    \ '-changed'    : {'args': -1, 'default': 'HEAD'},
     \ '-context'    : {'args': 1},
     \ '-filetype'   : {'args': 1},
     \ '-ignorecase' : {'args': 0},
@@ -186,6 +187,16 @@ func! s:ParseOptions(options_str) abort
 
         if opt.args == 0
             let options[name] = 1
+        elseif opt.args == -1
+            " optional argument, which is taken only if it can't be the
+            " pattern and is verified by s:IsOptionalArg()
+            if i < len(tokens) - 1 && tokens[i] !~# '^-'
+                \ && s:IsOptionalArg(name, tokens[i])
+                let options[name] = tokens[i]
+                let i += 1
+            else
+                let options[name] = opt.default
+            endif
         elseif opt.args == 1
             if tokens[i] =~# '\d\+'
                 let options[name] = str2nr(tokens[i])
@@ -209,6 +220,55 @@ func! s:ParseOptions(options_str) abort
     return options
 endf
 
+" s:IsOptionalArg()
+"
+func! s:IsOptionalArg(name, token) abort
+    if a:name ==# 'changed'
+        return ctrlsf#git#IsRevision(a:token)
+    endif
+    return 0
+endf
+
+" s:ChangedFiles()
+"
+" Return changed lines of files under given paths (or all if no path is
+" given) since base of '-changed'.
+"
+func! s:ChangedFiles() abort
+    let changes = ctrlsf#git#Changes(s:options['changed'])
+    if type(changes) != type({})
+        throw 'ParseOptionsException'
+    endif
+
+    if has_key(s:options, 'path')
+        let paths = map(copy(s:options['path']),
+            \ 'substitute(fnamemodify(v:val, ":p"), "/$", "", "")')
+        call filter(changes, 's:UnderPaths(v:key, paths)')
+    endif
+
+    if empty(changes)
+        call ctrlsf#log#Warn("No file has been changed since %s.",
+            \ s:options['changed'])
+        throw 'ParseOptionsException'
+    endif
+
+    return changes
+endf
+
+" s:UnderPaths()
+"
+" Check if {file} is one of {paths} or under one of them. Note that 'foo.c'
+" is not under 'foo'.
+"
+func! s:UnderPaths(file, paths) abort
+    for path in a:paths
+        if a:file ==# path || stridx(a:file, path . '/') == 0
+            return 1
+        endif
+    endfo
+    return 0
+endf
+
 " ParseOptions()
 "
 func! ctrlsf#opt#ParseOptions(options_str) abort
@@ -222,5 +282,10 @@ func! ctrlsf#opt#ParseOptions(options_str) abort
     " vimhlregex
     let s:options["_vimhlregex"] = ctrlsf#pat#HighlightRegex()
 
+    " changed lines of files to search in
+    if has_key(s:options, 'changed')
+        let s:options["_changed"] = s:ChangedFiles()
+    endif
+
     call ctrlsf#log#Debug("Options: %s", string(s:options))
 endf
@@ -60,7 +60,8 @@ func! ctrlsf#view#Render() abort
 
             if line.matched()
                 let line.match.vlnum = len(view)
-                let line.match.vcol  = line.match.col + ctrlsf#view#Indent()
+                let line.match.vcol  = line.match.col + ctrlsf#db#Shift(line)
+                    \ + ctrlsf#view#Indent()
             endif
         endfo
     endfo
@@ -68,6 +69,56 @@ func! ctrlsf#view#Render() abort
     return join(view, "\n")
 endf
 
+" Patch()
+"
+" Reassign vlnum of lines in resultset the same way Render() does, but only
+" render summary and paragraphs belonging to {files}.
+"
+" Returns
+" [count, lines] count of lines in whole view and list of [vlnum, content] to
+"                be compared against current view
+"
+func! ctrlsf#view#Patch(files) abort
+    let resultset = ctrlsf#db#ResultSet()
+    let indent    = ctrlsf#view#Indent()
+    let cur_file  = ''
+
+    let files = {}
+    for file in a:files
+        let files[file] = 1
+    endfo
+
+    let lines = [[1, s:Summary(resultset)[0]]]
+    let vlnum = 1
+
+    for par in resultset
+        if cur_file !=# par.file
+            let cur_file = par.file
+            let vlnum += len(s:Filename(par))
+        else
+            let vlnum += len(s:Ellipsis())
+        endif
+
+        let patch = has_key(files, par.file)
+        for line in par.lines
+            let vlnum += 1
+            let line.vlnum = vlnum
+
+            if line.matched()
+                let line.match.vlnum = vlnum
+                let line.match.vcol  = line.match.col + ctrlsf#db#Shift(line)
+                    \ + indent
+            endif
+
+            if patch
+                call add(lines, [vlnum, s:Line(line)[0]])
+            endif
+        endfo
+    endfo
+
+    return [vlnum, lines]
+endf
+
 " Reflect()
 "
 " Find resultset which is corresponding the given line.
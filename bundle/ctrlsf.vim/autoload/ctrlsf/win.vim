@@ -69,6 +69,25 @@ endf
 func! ctrlsf#win#Draw() abort
     let content = ctrlsf#view#Render()
     silent! undojoin | keepjumps call ctrlsf#buf#WriteString(content)
+    call ctrlsf#hl#HighlightStale()
+endf
+
+" Patch()
+"
+" Update lines of paragraphs in {files} only, instead of redrawing the whole
+" view. Cursor, folds and highlights of other lines are kept intact.
+"
+" Returns
+" -1 if view is inconsistent with resultset and has to be redrawn
+"
+func! ctrlsf#win#Patch(files) abort
+    let [total, lines] = ctrlsf#view#Patch(a:files)
+    if total != line('$')
+        return -1
+    endif
+    silent! undojoin | keepjumps call ctrlsf#buf#SetLines(lines)
+    call ctrlsf#hl#HighlightStale()
+    return 0
 endf
 
 " CloseMainWindow()
@@ -129,6 +148,10 @@ func! s:InitMainWindow() abort
         au!
         au BufWriteCmd         <buffer> call ctrlsf#Save()
         au BufHidden,BufUnload <buffer> call ctrlsf#buf#UndoAllChanges()
+        au CursorMoved         <buffer> call ctrlsf#LoadVisibleContext()
+        if exists('##WinScrolled')
+            au WinScrolled     <buffer> call ctrlsf#LoadVisibleContext()
+        endif
     augroup END
 endf
 
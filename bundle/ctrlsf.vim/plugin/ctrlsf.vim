@@ -80,6 +80,12 @@ if !exists('g:ctrlsf_ackprg')
 endif
 " }}}
 
+" g:ctrlsf_anchor_range {{{2
+if !exists('g:ctrlsf_anchor_range')
+    let g:ctrlsf_anchor_range = 1000
+endif
+" }}}
+
 " g:ctrlsf_auto_close {{{2
 if !exists('g:ctrlsf_auto_close')
     let g:ctrlsf_auto_close = 1
@@ -92,6 +98,12 @@ if !exists('g:ctrlsf_case_sensitive')
 endif
 " }}}
 
+" g:ctrlsf_changed_hunks {{{2
+if !exists('g:ctrlsf_changed_hunks')
+    let g:ctrlsf_changed_hunks = 1
+endif
+" }}}
+
 " g:ctrlsf_confirm_save {{{2
 if !exists('g:ctrlsf_confirm_save')
     let g:ctrlsf_confirm_save = 1
@@ -122,6 +134,18 @@ if !exists('g:ctrlsf_indent')
 endif
 " }}}
 
+" g:ctrlsf_lazy_context {{{2
+if !exists('g:ctrlsf_lazy_context')
+    let g:ctrlsf_lazy_context = 0
+endif
+" }}}
+
+" g:ctrlsf_live_delay {{{2
+if !exists('g:ctrlsf_live_delay')
+    let g:ctrlsf_live_delay = 50
+endif
+" }}}
+
 " g:ctrlsf_mapping {{{
 let s:default_mapping = {
     \ "open"  : ["<CR>", "o"],
@@ -161,6 +185,12 @@ if !exists('g:ctrlsf_position')
 endif
 " }}}
 
+" g:ctrlsf_recent_first {{{2
+if !exists('g:ctrlsf_recent_first')
+    let g:ctrlsf_recent_first = 0
+endif
+" }}}
+
 " g:ctrlsf_regex_pattern {{{2
 if !exists('g:ctrlsf_regex_pattern')
     let g:ctrlsf_regex_pattern = 0
@@ -173,6 +203,12 @@ if !exists('g:ctrlsf_selected_line_hl')
 endif
 " }}}
 
+" g:ctrlsf_truncate_width {{{2
+if !exists('g:ctrlsf_truncate_width')
+    let g:ctrlsf_truncate_width = 512
+endif
+" }}}
+
 " g:ctrlsf_winsize {{{2
 if !exists('g:ctrlsf_winsize')
     if exists('g:ctrlsf_width')
@@ -185,6 +221,7 @@ endif
 
 " Commands {{{1
 com! -n=* -comp=customlist,ctrlsf#comp#Completion CtrlSF        call ctrlsf#Search(<q-args>)
+com! -n=* -comp=customlist,ctrlsf#comp#Completion CtrlSFLive    call ctrlsf#Live(<q-args>)
 com! -n=0                                         CtrlSFOpen    call ctrlsf#Open()
 com! -n=0                                         CtrlSFUpdate  call ctrlsf#Update()
 com! -n=0                                         CtrlSFClose   call ctrlsf#Quit()
@@ -20,5 +20,6 @@ hi def link ctrlsfMatch        MatchParen
 hi def link ctrlsfLnumMatch    SignColumn
 hi def link ctrlsfLnumUnmatch  LineNr
 hi def link ctrlsfSelectedLine Visual
+hi def link ctrlsfStale        WarningMsg
 
 let b:current_syntax = 'ctrlsf'
@@ -41,8 +41,13 @@ if exists("loaded_matchit") || &cp
   finish
 endif
 let loaded_matchit = 1
-let s:last_mps = ""
-let s:last_words = ":"
+" Compiled patterns, one slot for each combination of b:match_words and
+" 'matchpairs', in the order they were made.  See s:Compile().
+let s:compiled = {}
+let s:compiled_keys = []
+if !exists("g:match_cache_size")
+  let g:match_cache_size = 20
+endif
 
 let s:save_cpo = &cpo
 set cpo&vim
@@ -120,34 +125,7 @@ function! s:Match_wrapper(word, forward, mode) range
     execute "let match_words =" b:match_words
   endif
 " Thanks to Preben "Peppe" Guldberg and Bram Moolenaar for this suggestion!
-  if (match_words != s:last_words) || (&mps != s:last_mps) ||
-    \ exists("b:match_debug")
-    let s:last_words = match_words
-    let s:last_mps = &mps
-    " The next several lines were here before
-    " BF started messing with this script.
-    " quote the special chars in 'matchpairs', replace [,:] with \| and then
-    " append the builtin pairs (/*, */, #if, #ifdef, #else, #elif, #endif)
-    " let default = substitute(escape(&mps, '[$^.*~\\/?]'), '[,:]\+',
-    "  \ '\\|', 'g').'\|\/\*\|\*\/\|#if\>\|#ifdef\>\|#else\>\|#elif\>\|#endif\>'
-    let default = escape(&mps, '[$^.*~\\/?]') . (strlen(&mps) ? "," : "") .
-      \ '\/\*:\*\/,#if\%(def\)\=:#else\>:#elif\>:#endif\>'
-    " s:all = pattern with all the keywords
-    let match_words = match_words . (strlen(match_words) ? "," : "") . default
-    if match_words !~ s:notslash . '\\\d'
-      let s:do_BR = 0
-      let s:pat = match_words
-    else
-      let s:do_BR = 1
-      let s:pat = s:ParseWords(match_words)
-    endif
-    let s:all = substitute(s:pat, s:notslash . '\zs[,:]\+', '\\|', 'g')
-    let s:all = '\%(' . s:all . '\)'
-    " let s:all = '\%(' . substitute(s:all, '\\\ze[,:]', '', 'g') . '\)'
-    if exists("b:match_debug")
-      let b:match_pat = s:pat
-    endif
-  endif
+  let compiled = s:Compile("wrapper", match_words)
 
   " Second step:  set the following local variables:
   "     matchline = line on which the cursor started
@@ -191,14 +169,12 @@ function! s:Match_wrapper(word, forward, mode) range
   " group = colon-separated list of patterns, one of which matches
   "       = ini:mid:fin or ini:fin
   "
-  " Reconstruct the version with unresolved backrefs.
-  let patBR = substitute(match_words.',',
-    \ s:notslash.'\zs[,:]*,[,:]*', ',', 'g')
-  let patBR = substitute(patBR, s:notslash.'\zs:\{2,}', ':', 'g')
+  " The version with unresolved backrefs is compiled.patBR .
   " Now, set group and groupBR to the matching group: 'if:endif' or
   " 'while:endwhile' or whatever.  A bit of a kluge:  s:Choose() returns
   " group . "," . groupBR, and we pick it apart.
-  let group = s:Choose(s:pat, matchline, ",", ":", prefix, suffix, patBR)
+  let group = s:Choose(s:pat, matchline, ",", ":", prefix, suffix,
+    \ compiled.patBR)
   let i = matchend(group, s:notslash . ",")
   let groupBR = strpart(group, i)
   let group = strpart(group, 0, i-1)
@@ -213,19 +189,15 @@ function! s:Match_wrapper(word, forward, mode) range
   endif
 
   " Fourth step:  Set the arguments for searchpair().
-  let i = matchend(group, s:notslash . ":")
-  let j = matchend(group, '.*' . s:notslash . ":")
-  let ini = strpart(group, 0, i-1)
-  let mid = substitute(strpart(group, i,j-i-1), s:notslash.'\zs:', '\\|', 'g')
-  let fin = strpart(group, j)
-  "Un-escape the remaining , and : characters.
-  let ini = substitute(ini, s:notslash . '\zs\\\(:\|,\)', '\1', 'g')
-  let mid = substitute(mid, s:notslash . '\zs\\\(:\|,\)', '\1', 'g')
-  let fin = substitute(fin, s:notslash . '\zs\\\(:\|,\)', '\1', 'g')
-  " searchpair() requires that these patterns avoid \(\) groups.
-  let ini = substitute(ini, s:notslash . '\zs\\(', '\\%(', 'g')
-  let mid = substitute(mid, s:notslash . '\zs\\(', '\\%(', 'g')
-  let fin = substitute(fin, s:notslash . '\zs\\(', '\\%(', 'g')
+  " These depend on group only, so they are kept with the compiled patterns.
+  if !has_key(compiled.groups, group)
+    " With backrefs there is a group for each resolved word, e.g. each tag.
+    if len(compiled.groups) >= 100
+      let compiled.groups = {}
+    endif
+    let compiled.groups[group] = s:SplitGroup(group)
+  endif
+  let [ini, mid, fin] = compiled.groups[group]
   " Set mid.  This is optimized for readability, not micro-efficiency!
   if a:forward && matchline =~ prefix . fin . suffix
     \ || !a:forward && matchline =~ prefix . ini . suffix
@@ -623,6 +595,121 @@ fun! s:Match_debug()
   amenu &Matchit.t&able	:echo '0:' . b:match_table . ':9'<CR>
 endfun
 
+" Report the compiled versions of b:match_words kept between calls: the number
+" of slots and their approximate size in bytes.
+fun! MatchitMemoryUsage()
+  return {"patterns": {"entries": len(s:compiled),
+    \ "bytes": strlen(string(s:compiled))}}
+endfun
+
+" Forget the compiled patterns.  They are compiled again on the next call.
+fun! MatchitTrim()
+  let s:compiled = {}
+  let s:compiled_keys = []
+  unlet! s:pat s:all
+endfun
+
+" Return the compiled patterns for match_words and the current 'matchpairs'
+" and set the script variables
+"   s:do_BR	flag for whether there are backrefs
+"   s:pat	parsed version of b:match_words
+"   s:all	regexp based on s:pat and the default groups
+" Slots are keyed by the text of both, so switching between buffers or
+" filetypes reuses them and changing either one compiles a new slot.  The
+" oldest slot is dropped when there are more than g:match_cache_size.
+" kind is "wrapper" for s:Match_wrapper() or "multi" for s:MultiMatch(),
+" which build s:all slightly differently.
+fun! s:Compile(kind, match_words)
+  let key = a:kind . "\n" . &mps . "\n" . a:match_words
+  if !has_key(s:compiled, key) || exists("b:match_debug")
+    if !has_key(s:compiled, key)
+      call add(s:compiled_keys, key)
+    endif
+    let s:compiled[key] = s:Compile_{a:kind}(a:match_words)
+    while len(s:compiled_keys) > g:match_cache_size
+      call remove(s:compiled, remove(s:compiled_keys, 0))
+    endwhile
+  endif
+  let compiled = s:compiled[key]
+  let s:do_BR = compiled.do_BR
+  let s:pat = compiled.pat
+  let s:all = compiled.all
+  if exists("b:match_debug")
+    let b:match_pat = s:pat
+  endif
+  return compiled
+endfun
+
+" The default groups:  quote the special chars in 'matchpairs' and append the
+" builtin pairs (/*, */, #if, #ifdef, #else, #elif, #endif)
+fun! s:Default()
+  return escape(&mps, '[$^.*~\\/?]') . (strlen(&mps) ? "," : "") .
+    \ '\/\*:\*\/,#if\%(def\)\=:#else\>:#elif\>:#endif\>'
+endfun
+
+fun! s:Compile_wrapper(match_words)
+  let compiled = {"groups": {}}
+  let match_words = a:match_words . (strlen(a:match_words) ? "," : "") .
+    \ s:Default()
+  if match_words !~ s:notslash . '\\\d'
+    let compiled.do_BR = 0
+    let compiled.pat = match_words
+  else
+    let compiled.do_BR = 1
+    let compiled.pat = s:ParseWords(match_words)
+  endif
+  " all = pattern with all the keywords
+  let compiled.all = '\%(' .
+    \ substitute(compiled.pat, s:notslash . '\zs[,:]\+', '\\|', 'g') . '\)'
+  " Reconstruct the version with unresolved backrefs.
+  let patBR = substitute(match_words.',',
+    \ s:notslash.'\zs[,:]*,[,:]*', ',', 'g')
+  let compiled.patBR = substitute(patBR, s:notslash.'\zs:\{2,}', ':', 'g')
+  return compiled
+endfun
+
+fun! s:Compile_multi(match_words)
+  let compiled = {}
+  let default = s:Default()
+  if a:match_words !~ s:notslash . '\\\d'
+    let compiled.do_BR = 0
+    let compiled.pat = a:match_words
+  else
+    let compiled.do_BR = 1
+    let compiled.pat = s:ParseWords(a:match_words)
+  endif
+  let pat = compiled.pat
+  let compiled.all = '\%(' . substitute(pat . (strlen(pat)?",":"") . default,
+    \	'[,:]\+','\\|','g') . '\)'
+  let cdefault = (pat =~ '[^,]$' ? "," : "") . default
+  let open =  substitute(pat . cdefault,
+	\ s:notslash . '\zs:.\{-}' . s:notslash . ',', '\\),\\(', 'g')
+  let compiled.open =  '\(' . substitute(open, s:notslash . '\zs:.*$', '\\)', '')
+  let close = substitute(pat . cdefault,
+	\ s:notslash . '\zs,.\{-}' . s:notslash . ':', '\\),\\(', 'g')
+  let compiled.close = substitute(close, '^.\{-}' . s:notslash . ':', '\\(', '')
+    \ . '\)'
+  return compiled
+endfun
+
+" Split group = ini:mid:fin or ini:fin into the patterns for searchpair().
+fun! s:SplitGroup(group)
+  let i = matchend(a:group, s:notslash . ":")
+  let j = matchend(a:group, '.*' . s:notslash . ":")
+  let ini = strpart(a:group, 0, i-1)
+  let mid = substitute(strpart(a:group, i,j-i-1), s:notslash.'\zs:', '\\|', 'g')
+  let fin = strpart(a:group, j)
+  "Un-escape the remaining , and : characters.
+  let ini = substitute(ini, s:notslash . '\zs\\\(:\|,\)', '\1', 'g')
+  let mid = substitute(mid, s:notslash . '\zs\\\(:\|,\)', '\1', 'g')
+  let fin = substitute(fin, s:notslash . '\zs\\\(:\|,\)', '\1', 'g')
+  " searchpair() requires that these patterns avoid \(\) groups.
+  let ini = substitute(ini, s:notslash . '\zs\\(', '\\%(', 'g')
+  let mid = substitute(mid, s:notslash . '\zs\\(', '\\%(', 'g')
+  let fin = substitute(fin, s:notslash . '\zs\\(', '\\%(', 'g')
+  return [ini, mid, fin]
+endfun
+
 " Jump to the nearest unmatched "(" or "if" or "<tag>" if a:spflag == "bW"
 " or the nearest unmatched "</tag>" or "endif" or ")" if a:spflag == "W".
 " Return a "mark" for the original position, so that
@@ -647,45 +734,19 @@ fun! s:MultiMatch(spflag, mode)
   "   s:do_BR	flag for whether there are backrefs
   "   s:pat	parsed version of b:match_words
   "   s:all	regexp based on s:pat and the default groups
-  " This part is copied and slightly modified from s:Match_wrapper().
-  let default = escape(&mps, '[$^.*~\\/?]') . (strlen(&mps) ? "," : "") .
-    \ '\/\*:\*\/,#if\%(def\)\=:#else\>:#elif\>:#endif\>'
   " Allow b:match_words = "GetVimMatchWords()" .
   if b:match_words =~ ":"
     let match_words = b:match_words
   else
     execute "let match_words =" b:match_words
   endif
-  if (match_words != s:last_words) || (&mps != s:last_mps) ||
-    \ exists("b:match_debug")
-    let s:last_words = match_words
-    let s:last_mps = &mps
-    if match_words !~ s:notslash . '\\\d'
-      let s:do_BR = 0
-      let s:pat = match_words
-    else
-      let s:do_BR = 1
-      let s:pat = s:ParseWords(match_words)
-    endif
-    let s:all = '\%(' . substitute(s:pat . (strlen(s:pat)?",":"") . default,
-      \	'[,:]\+','\\|','g') . '\)'
-    if exists("b:match_debug")
-      let b:match_pat = s:pat
-    endif
-  endif
+  let compiled = s:Compile("multi", match_words)
 
   " Second step:  figure out the patterns for searchpair()
   " and save the screen, cursor position, and 'ignorecase'.
-  " - TODO:  A lot of this is copied from s:Match_wrapper().
-  " - maybe even more functionality should be split off
-  " - into separate functions!
-  let cdefault = (s:pat =~ '[^,]$' ? "," : "") . default
-  let open =  substitute(s:pat . cdefault,
-	\ s:notslash . '\zs:.\{-}' . s:notslash . ',', '\\),\\(', 'g')
-  let open =  '\(' . substitute(open, s:notslash . '\zs:.*$', '\\)', '')
-  let close = substitute(s:pat . cdefault,
-	\ s:notslash . '\zs,.\{-}' . s:notslash . ':', '\\),\\(', 'g')
-  let close = substitute(close, '^.\{-}' . s:notslash . ':', '\\(', '') . '\)'
+  " The open and close patterns are compiled by s:Compile().
+  let open = compiled.open
+  let close = compiled.close
   if exists("b:match_skip")
     let skip = b:match_skip
   elseif exists("b:match_comment") " backwards compatibility and testing!
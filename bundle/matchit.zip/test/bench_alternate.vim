@@ -0,0 +1,38 @@
+" Benchmark of pattern compilation: alternates % between an HTML buffer and a
+" Vim buffer, so b:match_words changes on every jump.
+" Run from anywhere:
+"   vim -N -u NONE -i NONE -es -S test/bench_alternate.vim
+" Result is printed to stdout.
+
+set nocompatible hidden
+filetype plugin on
+syntax off
+execute 'source' fnameescape(expand('<sfile>:p:h:h') . '/plugin/matchit.vim')
+
+let s:count = 1000
+let s:dir = tempname()
+call mkdir(s:dir)
+call writefile(['<html>', '<body>', '<div class="a">', '<p>x</p>', '</div>',
+\ '</body>', '</html>'], s:dir . '/a.html')
+call writefile(['function! F()', '  if 1', '    echo 1', '  else', '    echo 2',
+\ '  endif', 'endfunction'], s:dir . '/a.vim')
+execute 'edit' fnameescape(s:dir . '/a.html')
+execute 'edit' fnameescape(s:dir . '/a.vim')
+
+let s:start = reltime()
+for s:i in range(s:count)
+  execute 'buffer' fnameescape(s:dir . '/a.html')
+  call cursor(3, 2)
+  normal %
+  execute 'buffer' fnameescape(s:dir . '/a.vim')
+  call cursor(2, 3)
+  normal %
+endfor
+let s:elapsed = reltimefloat(reltime(s:start))
+let s:line = line('.')
+
+%bwipe!
+call delete(s:dir, 'rf')
+verbose echo printf("%d x %% alternating html/vim: %.2fs (landed on line %d)\n",
+\ 2 * s:count, s:elapsed, s:line)
+qall!
@@ -67,6 +67,19 @@ function! expand_region#next(mode, direction)
   call s:expand_region(a:mode, a:direction)
 endfunction
 
+" Returns the number of candidates held from the last expansion and their
+" approximate size in bytes
+function! expand_region#memory_usage()
+  return {'candidates': {'entries': len(s:candidates),
+        \ 'bytes': len(string(s:candidates))}}
+endfunction
+
+" Drops the candidates of the last expansion
+function! expand_region#trim()
+  let s:candidates = []
+  let s:cur_index = -1
+endfunction
+
 " ==============================================================================
 " Variables
 " ==============================================================================
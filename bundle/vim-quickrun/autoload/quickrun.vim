@@ -7,6 +7,7 @@ let s:save_cpo = &cpo
 set cpo&vim
 
 let s:V = vital#of('quickrun').load(
+\   'ConcurrentProcess',
 \   'Data.List',
 \   'System.File',
 \   'System.Filepath',
@@ -398,6 +399,14 @@ let g:quickrun#default_config = {
 \ },
 \ 'perl6': {'hook/eval/template': '{%s}().perl.print'},
 \ 'python': {'hook/eval/template': 'print(%s)'},
+\ 'python/cell': {
+\   'command': 'python',
+\   'cmdopt': '-u -m code -q',
+\   'outputter': 'buffer',
+\   'runner': 'cell',
+\   'runner/cell/load': "exec(compile(open('%S').read(), '%S', 'exec'))",
+\   'runner/cell/prompt': '>>> ',
+\ },
 \ 'php': {},
 \ 'ps1': {
 \   'exec': '%c %o -File %s %a',
@@ -582,6 +591,9 @@ function! s:Session.setup() abort
     if has_key(self, 'exit_code')
       call remove(self, 'exit_code')
     endif
+    if has_key(self, '_hook_dispatch')
+      call remove(self, '_hook_dispatch')
+    endif
     let self.config = deepcopy(self.base_config)
 
     let self.hooks = map(quickrun#module#get('hook'),
@@ -599,6 +611,10 @@ function! s:Session.setup() abort
     call filter(map(commands, 'self.build_command(quickrun#expand(v:val))'),
     \           'v:val =~# "\\S"')
     let self.commands = commands
+
+    " The set of hooks is fixed from here.  Dispatch lists are built lazily
+    " per point and reused, because 'output' is invoked for every chunk.
+    let self._hook_dispatch = {}
   catch /^quickrun:/
     call self.sweep()
     throw v:exception
@@ -797,16 +813,28 @@ endfunction
 
 function! s:Session.invoke_hook(point, ...) abort
   let context = a:0 ? a:1 : {}
+  if has_key(self, '_hook_dispatch')
+    if !has_key(self._hook_dispatch, a:point)
+      let self._hook_dispatch[a:point] = s:hook_dispatch(self.hooks, a:point)
+    endif
+    let dispatch = self._hook_dispatch[a:point]
+  else
+    let dispatch = s:hook_dispatch(self.hooks, a:point)
+  endif
+  for [hook, Func] in dispatch
+    call call(Func, [self, context], hook)
+  endfor
+endfunction
+
+" Returns the list of [hook, funcref] which implement the point, sorted by
+" priority.
+function! s:hook_dispatch(hooks, point) abort
   let func = 'on_' . a:point
-  let hooks = copy(self.hooks)
+  let hooks = filter(copy(a:hooks),
+  \                  'has_key(v:val, func) && s:V.Prelude.is_funcref(v:val[func])')
   let hooks = map(hooks, '[v:val, s:get_hook_priority(v:val, a:point)]')
   let hooks = s:V.Data.List.sort_by(hooks, 'v:val[1]')
-  let hooks = map(hooks, 'v:val[0]')
-  for hook in hooks
-    if has_key(hook, func) && s:V.Prelude.is_funcref(hook[func])
-      call call(hook[func], [self, context], hook)
-    endif
-  endfor
+  return map(hooks, '[v:val[0], v:val[0][func]]')
 endfunction
 
 function! s:get_hook_priority(hook, point) abort
@@ -850,6 +878,23 @@ function! quickrun#is_running() abort
   return !empty(s:sessions)
 endfunction
 
+" Returns {name: {'entries': n, 'bytes': n}} of the state held by quickrun.
+" bytes is approximate.
+function! quickrun#memory_usage() abort
+  return {
+  \   'sessions': {'entries': len(s:sessions),
+  \                'bytes': len(string(s:sessions))},
+  \   'hook/memo': quickrun#hook#memo#memory_usage(),
+  \   'ConcurrentProcess': s:V.ConcurrentProcess.memory_usage(),
+  \ }
+endfunction
+
+" Releases the caches.  Running sessions are kept.
+function! quickrun#trim() abort
+  call quickrun#hook#memo#clear()
+  call s:V.ConcurrentProcess.log_clear_all()
+endfunction
+
 
 " Interfaces.  {{{1
 function! quickrun#new(...) abort
@@ -902,6 +947,23 @@ function! quickrun#command(config, use_range, line1, line2) abort
   endtry
 endfunction
 
+" function for :QuickRunCell.
+function! quickrun#cell_command(config) abort
+  try
+    let type = &filetype . '/cell'
+    if has_key(g:quickrun#default_config, type)
+    \  || has_key(get(g:, 'quickrun_config', {}), type)
+      let config = {'type': type}
+    else
+      let config = {'runner': 'cell'}
+    endif
+    let config.mode = 'n'
+    call quickrun#run([config, a:config])
+  catch /^quickrun:/
+    call s:V.Vim.Message.error(v:exception)
+  endtry
+endfunction
+
 " completion function for main command.
 function! quickrun#complete(lead, cmd, pos) abort
   let line = split(a:cmd[:a:pos - 1], '', 1)
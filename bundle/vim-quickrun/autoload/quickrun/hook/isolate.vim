@@ -0,0 +1,147 @@
+" quickrun: hook/isolate: Isolates the execution for stable timings.
+" License: zlib License
+
+let s:save_cpo = &cpo
+set cpo&vim
+
+let s:hook = {
+\   'config': {
+\     'enable': 0,
+\     'cpus': '',
+\     'nice': '',
+\     'chrt': '',
+\     'aslr': 0,
+\     'memory': '',
+\     'warmup': [],
+\     'format': "\n*** isolate: %s ***",
+\   },
+\ }
+
+" Result of trial runs of wrappers.  command => 0/1
+let s:permitted = {}
+
+function! s:hook.init(session) abort
+  if !self.config.enable
+    return
+  endif
+  if g:quickrun#V.Prelude.is_windows()
+    let self.config.enable = 0
+    return
+  endif
+
+  let self._prefix = []
+  let params = {'skipped': []}
+
+  if self.config.cpus !=# ''
+    call s:wrap(self._prefix, params, 'cpus', self.config.cpus,
+    \           ['taskset', '-c', self.config.cpus])
+  endif
+  if self.config.nice !=# ''
+    call s:wrap(self._prefix, params, 'nice', self.config.nice,
+    \           ['nice', '-n', self.config.nice])
+  endif
+  if self.config.chrt !=# ''
+    call s:wrap(self._prefix, params, 'chrt', self.config.chrt,
+    \           ['chrt'] + split(self.config.chrt))
+  endif
+  if !self.config.aslr
+    let arch = matchstr(system('uname -m'), '\S\+')
+    call s:wrap(self._prefix, params, 'aslr', 'off',
+    \           ['setarch', arch, '-R'])
+  endif
+  if self.config.memory !=# ''
+    let params.memory = self.config.memory - 0
+  endif
+  let self._params = params
+endfunction
+
+function! s:hook.priority(point) abort
+  " Warm up before hook/time starts measuring.
+  return a:point ==# 'ready' ? -1 : 0
+endfunction
+
+function! s:hook.on_ready(session, context) abort
+  let files = map(copy(self.config.warmup), 'a:session.build_command(v:val)')
+  let files += [a:session.config.srcfile]
+  let input = get(a:session.base_config, 'input', '')
+  if input !=# '' && input[0] !=# '='
+    let files += [quickrun#expand(input)]
+  endif
+  call filter(files, 'filereadable(v:val)')
+  if !empty(files)
+    call system('cat ' . join(map(copy(files), 'shellescape(v:val)')) .
+    \           ' > /dev/null')
+    let self._params.warmup = files
+  endif
+
+  call map(a:session.commands, 's:isolate(v:val, self, a:session)')
+  let a:session.isolation = self._params
+endfunction
+
+function! s:hook.on_finish(session, context) abort
+  if self.config.format !=# ''
+    call a:session.output(printf(self.config.format,
+    \                            s:describe(self._params)))
+  endif
+endfunction
+
+
+function! s:wrap(prefix, params, name, value, command) abort
+  if s:is_permitted(a:command)
+    let a:params[a:name] = a:value
+    call extend(a:prefix, a:command)
+  else
+    call add(a:params.skipped, a:name)
+  endif
+endfunction
+
+function! s:is_permitted(command) abort
+  let cmd = join(map(copy(a:command), 'shellescape(v:val)'))
+  if !has_key(s:permitted, cmd)
+    let s:permitted[cmd] = 0
+    if executable(a:command[0])
+      call system(cmd . ' true')
+      let s:permitted[cmd] = v:shell_error == 0
+    endif
+  endif
+  return s:permitted[cmd]
+endfunction
+
+function! s:isolate(cmd, hook, session) abort
+  if a:cmd =~# '^\s*:'
+    " A vim command.
+    return a:cmd
+  endif
+  let cmd = a:cmd
+  if !empty(a:hook._prefix)
+    let cmd = join(map(copy(a:hook._prefix), 'shellescape(v:val)')) .
+    \         ' sh -c ' . a:session.runner.shellescape(cmd)
+  endif
+  if has_key(a:hook._params, 'memory')
+    let cmd = printf('ulimit -v %d && %s', a:hook._params.memory, cmd)
+  endif
+  return cmd
+endfunction
+
+function! s:describe(params) abort
+  let desc = []
+  for name in ['cpus', 'nice', 'chrt', 'aslr', 'memory']
+    if has_key(a:params, name)
+      call add(desc, name . '=' . a:params[name])
+    endif
+  endfor
+  if has_key(a:params, 'warmup')
+    call add(desc, 'warmup=' . len(a:params.warmup))
+  endif
+  if !empty(a:params.skipped)
+    call add(desc, 'skipped=' . join(a:params.skipped, ','))
+  endif
+  return join(desc)
+endfunction
+
+function! quickrun#hook#isolate#new() abort
+  return deepcopy(s:hook)
+endfunction
+
+let &cpo = s:save_cpo
+unlet s:save_cpo
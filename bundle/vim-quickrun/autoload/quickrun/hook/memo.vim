@@ -0,0 +1,140 @@
+" quickrun: hook/memo: Replays the stored result of an identical run.
+" License: zlib License
+
+let s:save_cpo = &cpo
+set cpo&vim
+
+" key => {'output': string, 'exit_code': number, 'size': number, 'atime': n}
+let s:cache = {}
+let s:cache_size = 0
+let s:clock = 0
+
+let s:hook = {
+\   'config': {
+\     'enable': 0,
+\     'max_entries': 64,
+\     'max_size': 1048576,
+\   },
+\ }
+
+function! s:hook.init(session) abort
+  if !exists('*sha256')
+    let self.config.enable = 0
+  endif
+endfunction
+
+function! s:hook.priority(point) abort
+  " Record the raw output before the other hooks convert it; the replay goes
+  " through session.output() again.  Stop recording before the other hooks
+  " append something at "finish".
+  return a:point ==# 'output' || a:point ==# 'finish' ? -1 : 0
+endfunction
+
+function! s:hook.on_ready(session, context) abort
+  let self._key = s:make_key(a:session)
+  if has_key(s:cache, self._key)
+    let entry = s:cache[self._key]
+    let s:clock += 1
+    let entry.atime = s:clock
+    let runner = extend(copy(a:session.runner), s:replay_runner)
+    let runner._memo = entry
+    let a:session.runner = runner
+  else
+    let self._output = []
+  endif
+endfunction
+
+function! s:hook.on_output(session, context) abort
+  if has_key(self, '_output')
+    call add(self._output, a:context.data)
+  endif
+endfunction
+
+function! s:hook.on_finish(session, context) abort
+  if !has_key(self, '_output')
+    return
+  endif
+  let output = join(remove(self, '_output'), '')
+  if !has_key(a:session, 'exit_code')
+    return
+  endif
+  call s:store(self._key, output, a:session.exit_code, self.config)
+endfunction
+
+let s:replay_runner = {}
+
+function! s:replay_runner.run(commands, input, session) abort
+  if self._memo.output !=# ''
+    call a:session.output(self._memo.output)
+  endif
+  return self._memo.exit_code
+endfunction
+
+
+function! s:make_key(session) abort
+  let config = a:session.config
+  let srcfile = config.srcfile
+  let source = filereadable(srcfile) ? readfile(srcfile, 'b') : []
+  " A temporary file has a new name for each run.
+  let path = index(get(a:session, '_temp_names', []), srcfile) < 0
+  \          ? fnamemodify(srcfile, ':p') : ''
+  return sha256(string([config.command, config.exec, config.cmdopt,
+  \                     config.args, config.input, path, getcwd(), source]))
+endfunction
+
+function! s:store(key, output, exit_code, config) abort
+  let size = len(a:output)
+  let max_size = a:config.max_size - 0
+  if 0 < max_size && max_size < size
+    return
+  endif
+  call s:remove(a:key)
+  let s:clock += 1
+  let s:cache[a:key] = {
+  \   'output': a:output,
+  \   'exit_code': a:exit_code,
+  \   'size': size,
+  \   'atime': s:clock,
+  \ }
+  let s:cache_size += size
+  let max_entries = a:config.max_entries - 0
+  while !empty(s:cache) &&
+  \     ((0 < max_entries && max_entries < len(s:cache)) ||
+  \      (0 < max_size && max_size < s:cache_size))
+    call s:remove(s:least_recently_used())
+  endwhile
+endfunction
+
+function! s:remove(key) abort
+  if has_key(s:cache, a:key)
+    let s:cache_size -= remove(s:cache, a:key).size
+  endif
+endfunction
+
+function! s:least_recently_used() abort
+  let [lru_key, lru_time] = ['', -1]
+  for [key, entry] in items(s:cache)
+    if lru_time < 0 || entry.atime < lru_time
+      let [lru_key, lru_time] = [key, entry.atime]
+    endif
+  endfor
+  return lru_key
+endfunction
+
+
+function! quickrun#hook#memo#memory_usage() abort
+  return {'entries': len(s:cache), 'bytes': s:cache_size}
+endfunction
+
+" Drops all stored results.
+function! quickrun#hook#memo#clear() abort
+  let s:cache = {}
+  let s:cache_size = 0
+endfunction
+
+function! quickrun#hook#memo#new() abort
+  return deepcopy(s:hook)
+endfunction
+
+let &cpo = s:save_cpo
+unlet s:save_cpo
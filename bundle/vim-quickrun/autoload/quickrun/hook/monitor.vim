@@ -0,0 +1,267 @@
+" quickrun: hook/monitor: Samples the resource usage of the running process.
+" License: zlib License
+
+let s:save_cpo = &cpo
+set cpo&vim
+
+let s:hook = {
+\   'config': {
+\     'enable': 0,
+\     'interval': 1000,
+\     'statusline': 1,
+\     'format': "\n*** monitor: %s ***",
+\   },
+\ }
+
+" timer id => [hook, session]
+let s:monitors = {}
+" bufnr of outputter buffer => hook
+let s:buffers = {}
+" The hook which sampled last.
+let s:last = {}
+let s:clock_ticks = 0
+
+function! s:hook.init(session) abort
+  if !has('timers') || !isdirectory('/proc')
+    let self.config.enable = 0
+  endif
+endfunction
+
+function! s:hook.on_ready(session, context) abort
+  let self._start = reltime()
+  let self._sample = {'elapsed': 0.0}
+  let self._ticks = [0, 0.0]
+  let self._status = ''
+  let self._timer = timer_start(self.config.interval - 0,
+  \                             function('s:tick'), {'repeat': -1})
+  let s:monitors[self._timer] = [self, a:session]
+endfunction
+
+function! s:hook.on_outputter_buffer_opened(session, context) abort
+  if self.config.statusline
+    let self._statusline = [bufnr('%'), &l:statusline]
+    let s:buffers[bufnr('%')] = self
+    let &l:statusline = '%f%=%{quickrun#hook#monitor#status(bufnr("%"))} '
+  endif
+endfunction
+
+function! s:hook.on_finish(session, context) abort
+  call s:stop(self)
+  call s:sample(self, a:session)
+  let a:session.monitor = self._sample
+  if self.config.format !=# ''
+    call a:session.output(printf(self.config.format, self._status))
+  endif
+endfunction
+
+function! s:hook.sweep() abort
+  call s:stop(self)
+  call s:restore_statusline(self)
+endfunction
+
+
+function! s:tick(timer) abort
+  if !has_key(s:monitors, a:timer)
+    call timer_stop(a:timer)
+    return
+  endif
+  let [hook, session] = s:monitors[a:timer]
+  call s:sample(hook, session)
+  redrawstatus!
+endfunction
+
+function! s:stop(hook) abort
+  if has_key(a:hook, '_timer')
+    call timer_stop(a:hook._timer)
+    call remove(s:monitors, remove(a:hook, '_timer'))
+  endif
+endfunction
+
+function! s:restore_statusline(hook) abort
+  if !has_key(a:hook, '_statusline')
+    return
+  endif
+  let [bufnr, statusline] = remove(a:hook, '_statusline')
+  if get(s:buffers, bufnr, {}) is a:hook
+    call remove(s:buffers, bufnr)
+    for winid in win_findbuf(bufnr)
+      call setwinvar(winid, '&statusline', statusline)
+    endfor
+  endif
+endfunction
+
+" Updates hook._sample.  The figures of the last sample are kept when the
+" process has gone already.
+function! s:sample(hook, session) abort
+  let elapsed = reltimefloat(reltime(a:hook._start))
+  let sample = extend(copy(a:hook._sample), {'elapsed': elapsed})
+  let pid = s:pid(a:session)
+  let procs = pid ? s:read_tree(pid) : []
+  if !empty(procs)
+    let sum = {'ticks': 0, 'rss': 0, 'read': 0, 'write': 0}
+    for proc in procs
+      call map(sum, 'v:val + proc[v:key]')
+    endfor
+    let [ticks, time] = a:hook._ticks
+    let cpu = elapsed <= time ? 0 :
+    \   100.0 * max([0, sum.ticks - ticks]) / s:clock_ticks / (elapsed - time)
+    let a:hook._ticks = [sum.ticks, elapsed]
+    call extend(sample, {
+    \   'pid': pid,
+    \   'procs': len(procs),
+    \   'state': s:state(map(copy(procs), 'v:val.state')),
+    \   'cpu': cpu,
+    \   'rss': sum.rss,
+    \   'peak': max([get(sample, 'peak', 0), sum.rss]),
+    \   'read': sum.read,
+    \   'write': sum.write,
+    \ })
+  endif
+  let a:hook._sample = sample
+  let a:hook._status = s:describe(sample)
+  let s:last = a:hook
+endfunction
+
+function! s:pid(session) abort
+  if has_key(a:session, '_vimproc')
+    return get(a:session._vimproc, 'pid', 0)
+  endif
+  let runner = get(a:session, 'runner', {})
+  if has_key(runner, '_label')
+    return g:quickrun#V.ConcurrentProcess.pid(runner._label)
+  endif
+  return 0
+endfunction
+
+" Reads the process {pid} and the processes started by it: its descendants,
+" and the processes in its process group or session, which are still found
+" when the parent has exited.  "/proc/{pid}/task/{tid}/children" is not used
+" as it lists the children of one thread only and needs
+" CONFIG_PROC_CHILDREN.
+function! s:read_tree(pid) abort
+  if s:clock_ticks == 0
+    let s:clock_ticks = str2nr(system('getconf CLK_TCK'))
+    let s:clock_ticks = s:clock_ticks > 0 ? s:clock_ticks : 100
+  endif
+  " pid => fields of /proc/{pid}/stat after the command name
+  let stats = {}
+  " ppid => list of pid
+  let children = {}
+  for dir in glob('/proc/[0-9]*', 1, 1)
+    let stat = s:read_stat(dir)
+    if len(stat) >= 15
+      let pid = str2nr(fnamemodify(dir, ':t'))
+      let stats[pid] = stat
+      if !has_key(children, stat[1])
+        let children[stat[1]] = []
+      endif
+      call add(children[stat[1]], pid)
+    endif
+  endfor
+
+  let pids = [a:pid] + filter(keys(stats),
+  \   'stats[v:val][2] == a:pid || stats[v:val][3] == a:pid')
+  let procs = []
+  let seen = {}
+  while !empty(pids)
+    let pid = remove(pids, 0)
+    if has_key(seen, pid) || !has_key(stats, pid)
+      continue
+    endif
+    let seen[pid] = 1
+    let proc = s:read_proc(pid, stats[pid])
+    if !empty(proc)
+      call add(procs, proc)
+    endif
+    let pids += get(children, pid, [])
+  endwhile
+  return procs
+endfunction
+
+function! s:read_stat(dir) abort
+  try
+    return split(matchstr(join(readfile(a:dir . '/stat')), ')\s\zs.*'))
+  catch
+    " The process has exited.
+    return []
+  endtry
+endfunction
+
+function! s:read_proc(pid, stat) abort
+  let dir = '/proc/' . a:pid
+  try
+    let status = readfile(dir . '/status')
+    let io = filereadable(dir . '/io') ? readfile(dir . '/io') : []
+  catch
+    " The process has exited.
+    return {}
+  endtry
+  " utime, stime, cutime and cstime.  cutime and cstime keep the time of the
+  " children which have exited.
+  let ticks = 0
+  for field in a:stat[11 : 14]
+    let ticks += str2nr(field)
+  endfor
+  return {
+  \   'state': a:stat[0],
+  \   'ticks': ticks,
+  \   'rss': s:field(status, 'VmRSS') * 1024,
+  \   'read': s:field(io, 'rchar'),
+  \   'write': s:field(io, 'wchar'),
+  \ }
+endfunction
+
+function! s:field(lines, name) abort
+  let line = get(filter(copy(a:lines), 'v:val =~# "^" . a:name . ":"'), 0, '')
+  return str2nr(matchstr(line, '\d\+'))
+endfunction
+
+" The state which tells the most: uninterruptible sleep (usually I/O) first,
+" then running.
+function! s:state(states) abort
+  for state in ['D', 'R']
+    if index(a:states, state) >= 0
+      return state
+    endif
+  endfor
+  return get(a:states, 0, '?')
+endfunction
+
+function! s:describe(sample) abort
+  let desc = []
+  if has_key(a:sample, 'pid')
+    call add(desc, printf('[%s] cpu %d%%', a:sample.state, float2nr(a:sample.cpu)))
+    call add(desc, printf('rss %s (peak %s)',
+    \                     s:size(a:sample.rss), s:size(a:sample.peak)))
+    call add(desc, printf('r %s w %s',
+    \                     s:size(a:sample.read), s:size(a:sample.write)))
+  endif
+  call add(desc, printf('%.1fs', a:sample.elapsed))
+  return join(desc)
+endfunction
+
+function! s:size(bytes) abort
+  let size = a:bytes * 1.0
+  for unit in ['B', 'K', 'M', 'G']
+    if size < 1024 || unit ==# 'G'
+      return unit ==# 'B' ? printf('%d%s', a:bytes, unit)
+      \                   : printf('%.1f%s', size, unit)
+    endif
+    let size = size / 1024
+  endfor
+endfunction
+
+
+" Returns the description of the last sample of the session whose output is
+" shown in buffer [bufnr], or of the session which sampled last.
+function! quickrun#hook#monitor#status(...) abort
+  let hook = a:0 ? get(s:buffers, a:1, {}) : s:last
+  return get(hook, '_status', '')
+endfunction
+
+function! quickrun#hook#monitor#new() abort
+  return deepcopy(s:hook)
+endfunction
+
+let &cpo = s:save_cpo
+unlet s:save_cpo
@@ -0,0 +1,190 @@
+" quickrun: runner/cell: Runs the changed cells in a persistent process.
+" Based on runner/concurrent_process by ujihisa <ujihisa at gmail com>
+" License: zlib License
+
+let s:save_cpo = &cpo
+set cpo&vim
+
+let s:runner = {
+\   'config': {
+\     'load': 'load %s',
+\     'prompt': '>>> ',
+\     'marker': '^\s*#\s*%%',
+\     'header': "--- [%d]%s ---\n",
+\   }
+\ }
+
+let s:M = g:quickrun#V.import('Vim.Message')
+let s:CP = g:quickrun#V.import('ConcurrentProcess')
+
+" The cells each process has run.
+" label => {'pid': n, 'source': bufnr, 'cells': [text], 'outputs': [output],
+"           'failed': [0/1], 'queued': [the names of reads not consumed yet]}
+let s:kernels = {}
+
+augroup plugin-quickrun-cell
+augroup END
+
+function! s:runner.validate() abort
+  if !s:CP.is_available()
+    throw 'Needs vimproc.'
+  endif
+endfunction
+
+function! s:runner.run(commands, input, session) abort
+  let cells = s:split(readfile(a:session.config.srcfile), self.config.marker)
+
+  let cmd = printf('%s %s', a:session.config.command, a:session.config.cmdopt)
+  let cmd = g:quickrun#V.Process.iconv(cmd, &encoding, &termencoding)
+  let initial = [['*read*', '_', self.config.prompt]]
+
+  let label = s:CP.of(cmd, '', initial)
+  let queued = get(get(s:kernels, label, {}), 'queued', [])
+  if !empty(queued)
+    if s:CP.is_busy(label)
+      call s:CP.shutdown(label)
+      call s:M.warn('Previous cells were still running. Restarted.')
+      let label = s:CP.of(cmd, '', initial)
+    else
+      " The previous session was swept after the cells ran.
+      call map(queued, 's:CP.consume(label, v:val)')
+    endif
+  endif
+
+  let kernel = get(s:kernels, label, {})
+  let source = bufnr('%')
+  if empty(kernel) || kernel.pid != s:CP.pid(label) || kernel.source != source
+    " The state of the process is unknown.
+    let kernel = {'pid': s:CP.pid(label), 'source': source,
+    \             'cells': [], 'outputs': [], 'failed': [], 'queued': []}
+    let s:kernels[label] = kernel
+  endif
+
+  " Cells after a changed cell may depend on it.
+  let first = 0
+  while first < len(cells) && first < len(kernel.cells)
+  \     && cells[first] ==# kernel.cells[first] && !kernel.failed[first]
+    let first += 1
+  endwhile
+  let kernel.queued = []
+  for key in ['cells', 'outputs', 'failed']
+    let kernel[key] = first ? kernel[key][: first - 1] : []
+  endfor
+
+  for i in range(first)
+    call a:session.output(s:header(self.config, i, 1) . kernel.outputs[i])
+  endfor
+  if first == len(cells)
+    return 0
+  endif
+
+  let srcfile = a:session.config.srcfile
+  for i in range(first, len(cells) - 1)
+    let fname = a:session.tempname()
+    call writefile(split(cells[i], "\n", 1), fname, 'b')
+    let a:session.config.srcfile = fname
+    let message = a:session.build_command(self.config.load)
+    call s:CP.queue(label, [
+    \   ['*writeln*', message],
+    \   ['*read*', 'cell' . i, self.config.prompt]])
+    call add(kernel.queued, 'cell' . i)
+  endfor
+  let a:session.config.srcfile = srcfile
+
+  let self._label = label
+  let self._cells = cells
+  let self._next = first
+  let self._output = ''
+  let self._failed = 0
+  call a:session.output(s:header(self.config, first, 0))
+
+  let key = a:session.continue()
+  augroup plugin-quickrun-cell
+    execute 'autocmd! CursorHold,CursorHoldI * call'
+    \       's:receive(' . string(key) . ')'
+  augroup END
+  let self._autocmd = 1
+  let self._updatetime = &updatetime
+  let &updatetime = 50
+endfunction
+
+function! s:receive(key) abort
+  if getcmdwintype() !=# ''
+    return 0
+  endif
+
+  let session = quickrun#session(a:key)
+  let runner = session.runner
+  let kernel = s:kernels[runner._label]
+  while runner._next < len(runner._cells)
+    let rname = kernel.queued[0]
+    let done = s:CP.is_done(runner._label, rname)
+    let [out, err] = s:CP.consume(runner._label, rname)
+    let out .= err ==# '' ? '' : printf('!!!%s!!!', err)
+    let runner._output .= out
+    let runner._failed = runner._failed || err !=# ''
+    call session.output(out)
+    if !done
+      break
+    endif
+
+    call add(kernel.cells, runner._cells[runner._next])
+    call add(kernel.outputs, runner._output)
+    call add(kernel.failed, runner._failed)
+    call remove(kernel.queued, 0)
+    let runner._next += 1
+    let runner._output = ''
+    let runner._failed = 0
+    if runner._next < len(runner._cells)
+      call session.output(s:header(runner.config, runner._next, 0))
+    endif
+  endwhile
+
+  if runner._next == len(runner._cells)
+    call session.finish(index(kernel.failed, 1) < 0 ? 0 : 1)
+    return 1
+  endif
+
+  call quickrun#trigger_keys()
+  return 0
+endfunction
+
+function! s:runner.sweep() abort
+  if has_key(self, '_autocmd')
+    autocmd! plugin-quickrun-cell
+  endif
+  if has_key(self, '_updatetime')
+    let &updatetime = self._updatetime
+  endif
+endfunction
+
+function! quickrun#runner#cell#new() abort
+  return deepcopy(s:runner)
+endfunction
+
+" Splits the lines into cells at the lines matching the marker.  Cells which
+" have only blank lines are dropped.
+function! s:split(lines, marker) abort
+  let cells = []
+  let cell = []
+  for line in a:lines
+    if line =~# a:marker && !empty(cell)
+      call add(cells, cell)
+      let cell = []
+    endif
+    call add(cell, line)
+  endfor
+  call add(cells, cell)
+  call filter(cells, 'match(v:val, "\\S") >= 0')
+  return map(cells, 'join(v:val, "\n")')
+endfunction
+
+function! s:header(config, index, cached) abort
+  if a:config.header ==# ''
+    return ''
+  endif
+  return printf(a:config.header, a:index + 1, a:cached ? ' (cached)' : '')
+endfunction
+
+let &cpo = s:save_cpo
+unlet s:save_cpo
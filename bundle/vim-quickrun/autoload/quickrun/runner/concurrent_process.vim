@@ -53,6 +53,7 @@ function! s:runner.run(commands, input, session) abort
           \ ['*read*', 'x', self.config.prompt]])
   endif
 
+  let self._label = label
   let a:session._cmd = cmd
   let a:session._prompt = self.config.prompt
   let key = a:session.continue()
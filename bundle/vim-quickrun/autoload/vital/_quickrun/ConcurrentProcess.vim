@@ -243,6 +243,30 @@ function! s:log_dump(label) abort
   let s:_process_info[a:label].logs = []
 endfunction
 
+" Returns the pid of the process, which changes when the process has been
+" restarted.
+function! s:pid(label) abort
+  return get(s:_process_info[a:label].vp, 'pid', 0)
+endfunction
+
+" Returns the number of log entries of all processes and their approximate
+" size in bytes.
+function! s:memory_usage() abort
+  let [entries, bytes] = [0, 0]
+  for pi in values(s:_process_info)
+    let entries += len(pi.logs)
+    let bytes += len(string(pi.logs)) + len(pi.buffer_out) + len(pi.buffer_err)
+  endfor
+  return {'entries': entries, 'bytes': bytes}
+endfunction
+
+" Wipe out the logs of all processes
+function! s:log_clear_all() abort
+  for pi in values(s:_process_info)
+    let pi.logs = []
+  endfor
+endfunction
+
 let &cpo = s:save_cpo
 unlet s:save_cpo
 " vim:set et ts=2 sts=2 sw=2 tw=0:
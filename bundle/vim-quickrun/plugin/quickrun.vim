@@ -14,6 +14,8 @@ set cpo&vim
 
 command! -nargs=* -range=0 -complete=customlist,quickrun#complete QuickRun
 \ call quickrun#command(<q-args>, <count>, <line1>, <line2>)
+command! -nargs=* -complete=customlist,quickrun#complete QuickRunCell
+\ call quickrun#cell_command(<q-args>)
 
 
 nnoremap <silent> <Plug>(quickrun-op)
@@ -0,0 +1,30 @@
+" Benchmark of hook dispatch: calls session.output() 100000 times with
+" hook/time enabled, as a streaming runner does once per chunk.
+" Run from anywhere:
+"   vim -N -u NONE -i NONE -es -S test/bench_output.vim
+" Result is printed to stdout.
+
+set nocompatible
+let &runtimepath = expand('<sfile>:p:h:h') . ',' . &runtimepath
+runtime plugin/quickrun.vim
+
+let s:count = 100000
+let s:session = quickrun#new({
+\   'type': 'sh',
+\   'src': 'true',
+\   'outputter': 'variable',
+\   'outputter/variable/name': 'g:bench_output',
+\   'hook/time/enable': 1,
+\ })
+call s:session.setup()
+call s:session.outputter.start(s:session)
+
+let s:start = reltime()
+for s:i in range(s:count)
+  call s:session.output('')
+endfor
+let s:elapsed = reltimefloat(reltime(s:start))
+call s:session.sweep()
+
+verbose echo printf("%d x session.output(): %.2fs\n", s:count, s:elapsed)
+qall!
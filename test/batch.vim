@@ -0,0 +1,36 @@
+" :Batch 结束后恢复语法和折叠, 关键字高亮不重复, 也不丢失
+let s:file = tempname() . '.vim'
+
+" :syntax off 会执行 au! Syntax, vimrc.bundles 中彩虹括号的 autocmd 不能被删掉
+let s:lines = readfile('vimrc.bundles')
+let s:first = match(s:lines, '^augroup rainbow_parentheses')
+for s:line in s:lines[s:first : match(s:lines, '^augroup END', s:first)]
+    execute s:line
+endfor
+let g:rainbow_loads = []
+for s:kind in ['Round', 'Square', 'Braces']
+    execute 'command! RainbowParenthesesLoad' . s:kind 'call add(g:rainbow_loads, &syntax)'
+endfor
+call writefile(['" TODO one', 'if 1', '  " NOTE two', 'endif'], s:file)
+execute 'edit' s:file
+setlocal foldmethod=indent
+let s:matches = len(getmatches())
+call assert_equal(2, s:matches)
+
+Batch normal! G$x
+call assert_equal('endi', getline(4))
+call assert_equal('indent', &l:foldmethod)
+call assert_equal(1, exists('g:syntax_on'))
+call assert_equal('vim', get(b:, 'current_syntax', ''))
+call assert_equal(s:matches, len(getmatches()))
+call assert_match('RainbowParenthesesLoadRound', execute('autocmd rainbow_parentheses Syntax'))
+
+" :syntax off 之后新打开的 buffer 仍然有关键字高亮
+new
+let g:rainbow_loads = []
+setfiletype vim
+call assert_equal(s:matches, len(getmatches()))
+call assert_equal(['vim', 'vim', 'vim'], g:rainbow_loads)
+
+%bwipe!
+call delete(s:file)
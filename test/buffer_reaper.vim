@@ -0,0 +1,22 @@
+" 隐藏 buffer 回收: 超过数量时卸载最久未访问的, 有 undo 历史的不卸载
+let g:buffer_reaper_max_count = 1
+let s:dir = tempname()
+call mkdir(s:dir)
+for s:name in ['a', 'b', 'c', 'd']
+    call writefile([s:name], s:dir . '/' . s:name)
+endfor
+
+execute 'edit' s:dir . '/a'
+call setline(1, 'changed')
+write
+for s:name in ['b', 'c', 'd']
+    execute 'edit' s:dir . '/' . s:name
+endfor
+sleep 300m
+
+" a 有 undo 历史, b 最久未访问被卸载, c 在预算内保留
+call assert_equal([1, 0, 1, 1], map(['a', 'b', 'c', 'd'], 'bufloaded(s:dir . "/" . v:val)'))
+call assert_equal(1, buflisted(s:dir . '/b'))
+
+call delete(s:dir, 'rf')
+%bwipe!
@@ -0,0 +1,64 @@
+" 目录树: 后台列目录, 每次最多显示 g:dir_tree_max_entries 项, 按 mtime 缓存
+let s:dir = tempname()
+call mkdir(s:dir . '/sub/deep', 'p')
+for s:i in range(25)
+    call writefile([], printf('%s/f%02d.txt', s:dir, s:i))
+endfor
+call writefile([], s:dir . '/skip.pyc')
+call writefile([], s:dir . '/sub/inner.txt')
+let g:dir_tree_max_entries = 10
+let g:dir_tree_ignore = ['\.pyc$']
+" 分多批应用忽略规则
+let g:dir_tree_filter_chunk = 4
+
+execute 'DirTree' s:dir
+call assert_equal(['(loading)'], getline(2, '$'))
+sleep 300m
+" 目录在前, 之后 9 个文件和剩余计数, 被忽略的文件不计入
+call assert_equal(11 + 1, line('$'))
+call assert_equal('▸ sub/', getline(2))
+call assert_equal('  f00.txt', getline(3))
+call assert_equal('... 16 more', getline('$'))
+
+" 在计数行上加载下一批
+normal G
+execute "normal \<CR>"
+call assert_equal('... 6 more', getline('$'))
+normal G
+execute "normal \<CR>"
+call assert_equal('  f24.txt', getline('$'))
+call assert_equal(-1, index(getline(1, '$'), '  skip.pyc'))
+
+" 展开子目录
+call cursor(2, 1)
+execute "normal \<CR>"
+call assert_equal('  (loading)', getline(3))
+sleep 300m
+call assert_equal(['▾ sub/', '  ▸ deep/', '    inner.txt'], getline(2, 4))
+call assert_equal(2, line('.'))
+
+" mtime 不变时直接使用缓存, 增加文件后重新列出
+execute "normal \<CR>"
+execute "normal \<CR>"
+call assert_equal('  ▸ deep/', getline(3))
+sleep 1100m
+call writefile([], s:dir . '/sub/added.txt')
+execute "normal \<CR>"
+execute "normal \<CR>"
+sleep 300m
+call assert_equal(['    added.txt', '    inner.txt'], getline(4, 5))
+
+" 打开文件
+call cursor(5, 1)
+execute "normal \<CR>"
+call assert_equal(s:dir . '/sub/inner.txt', expand('%:p'))
+call assert_equal(2, winnr('$'))
+
+" <leader>n 的 :DirTreeToggle 关闭再打开
+DirTreeToggle
+call assert_equal(1, winnr('$'))
+DirTreeToggle
+call assert_equal(2, winnr('$'))
+call assert_match('^dirtree://', bufname('%'))
+%bwipe!
+call delete(s:dir, 'rf')
@@ -0,0 +1,32 @@
+" easy-align 的 '#' 分隔符: 跳过字符串中的 #, 撇号不当作字符串的开始
+" 模式定义在 vimrc.bundles 中, 这里只取出 s:easy_align_* 几行执行
+let s:lines = readfile('vimrc.bundles')
+let s:first = match(s:lines, '^let s:easy_align_')
+let s:last = match(s:lines, '^let g:easy_align_delimiters\[''#''\]')
+execute substitute(join(s:lines[s:first : s:last - 1], "\n"), '\n\s*\\', '', 'g')
+let s:pattern = s:easy_align_outside_string . '#'
+
+for [s:line, s:col] in [
+            \ ['a = 1 # c', 6],
+            \ ["x = 'a # b' # c", 12],
+            \ ['s = "it''s # x" # y', 15],
+            \ ["it's # comment", 5],
+            \ ["key: don't # note", 11],
+            \ ["f = r'a#b' # c", 11],
+            \ ["x = b'#' # y", 9],
+            \ ]
+    call assert_equal(s:col, match(s:line, s:pattern), s:line)
+endfor
+
+" 长的散文/注释行: easy-align 会把模式包成 '^.\{-}\s*\zs\(' . pat . '\)',
+" 分支有歧义时没有 # 的行也要回溯很久
+let s:wrapped = '^.\{-}\s*\zs\(' . s:pattern . '\)'
+for [s:line, s:col] in [
+            \ [repeat("it's ", 300) . 'x', -1],
+            \ [repeat("it's ", 300) . '# x', 1500],
+            \ [repeat("'a' b's ", 200) . 'x', -1],
+            \ ]
+    let s:start = reltime()
+    call assert_equal(s:col, match(s:line, s:wrapped), s:line[: 20])
+    call assert_true(reltimefloat(reltime(s:start)) < 1.0, 'slow: ' . s:line[: 20])
+endfor
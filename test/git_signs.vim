@@ -0,0 +1,52 @@
+" git 标记: CRLF 文件不修改时没有标记, 不在仓库中和 worktree 中的文件
+let s:dir = tempname()
+call mkdir(s:dir . '/repo', 'p')
+call mkdir(s:dir . '/plain')
+call writefile(["one\r", "two\r", "three\r"], s:dir . '/repo/dos.txt')
+call writefile(['plain'], s:dir . '/plain/file.txt')
+call system('cd ' . shellescape(s:dir . '/repo') . ' && git init -q && git add dos.txt'
+            \ . ' && git -c user.name=t -c user.email=t@t commit -qm init'
+            \ . ' && git worktree add -q ../tree 2>/dev/null')
+
+function! s:Signs()
+    return map(sign_getplaced(bufnr('%'), {'group': 'git_signs'})[0].signs, '[v:val.lnum, v:val.name]')
+endfunction
+
+execute 'edit' s:dir . '/repo/dos.txt'
+call assert_equal('dos', &fileformat)
+sleep 500m
+call assert_equal([], s:Signs())
+call setline(2, 'TWO')
+doautocmd TextChanged
+sleep 500m
+call assert_equal([[2, 'git_signs_modified']], s:Signs())
+
+" worktree 中 .git 是文件
+execute 'edit' s:dir . '/tree/dos.txt'
+call append(3, 'four')
+doautocmd TextChanged
+sleep 500m
+call assert_equal([[4, 'git_signs_added']], s:Signs())
+bwipe!
+
+execute 'edit' s:dir . '/plain/file.txt'
+call setline(1, 'changed')
+doautocmd TextChanged
+sleep 500m
+call assert_equal([], s:Signs())
+
+" 暂存区变化后重新读取的暂存区版本换用新的临时文件, 旧的删掉
+let s:tmpdir = fnamemodify(tempname(), ':h')
+execute 'edit' s:dir . '/repo/dos.txt'
+sleep 500m
+let s:files = len(glob(s:tmpdir . '/*', 1, 1))
+for s:i in range(2)
+    sleep 1100m
+    call system('cd ' . shellescape(s:dir . '/repo') . ' && echo x >> dos.txt && git add dos.txt')
+    edit!
+    sleep 500m
+endfor
+call assert_equal(s:files, len(glob(s:tmpdir . '/*', 1, 1)))
+
+%bwipe!
+call delete(s:dir, 'rf')
@@ -0,0 +1,14 @@
+" markdown 标题折叠: 嵌套章节的折叠层级
+new
+call setline(1, ['# A', 'intro', '## B', 'x', '## C', 'y', '# D', 'z'])
+set filetype=markdown
+call assert_equal([1, 1, 2, 2, 2, 2, 1, 1], map(range(1, 8), 'foldlevel(v:val)'))
+
+" 修改后重建, 已关闭的折叠保持关闭
+1foldopen
+3foldclose
+call append(4, ['### B1', 'w'])
+doautocmd InsertLeave
+call assert_equal([1, 1, 2, 2, 3, 3, 2, 2, 1, 1], map(range(1, 10), 'foldlevel(v:val)'))
+call assert_equal(3, foldclosed(5))
+bwipe!
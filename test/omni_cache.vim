@@ -0,0 +1,32 @@
+" omnifunc 补全缓存: 在缓存中过滤的结果与直接调用 omnifunc 一致, 规则未知的 omnifunc 不包装
+let s:words = ['abc', 'aBd', 'ABE', 'xab', 'xAbc', 'abx']
+function! OmniTest(findstart, base)
+    if a:findstart
+        return 0
+    endif
+    return filter(copy(s:words), 'v:val =~? "^" . a:base') + filter(copy(s:words), 'v:val !~? "^" . a:base && v:val =~? a:base')
+endfunction
+function! OmniPrefix(findstart, base)
+    return a:findstart ? 0 : filter(copy(s:words), 'stridx(v:val, a:base) == 0')
+endfunction
+let g:omni_cache_filetypes = ['omnitest']
+let g:omni_cache_funcs = {'OmniTest': 'ignorecase', 'OmniPrefix': 'prefix'}
+
+for s:func in ['OmniTest', 'OmniPrefix']
+    enew!
+    execute 'setlocal omnifunc=' . s:func
+    setfiletype omnitest
+    call assert_equal('OmniCache', &omnifunc)
+    call assert_equal(0, OmniCache(1, ''))
+    call OmniCache(0, 'a')
+    for s:base in ['ab', 'aB', 'abc', 'x']
+        call assert_equal(call(s:func, [0, s:base]), OmniCache(0, s:base), s:func . ' ' . s:base)
+    endfor
+endfor
+
+enew!
+setlocal omnifunc=OmniUnknown
+setfiletype omnitest
+call assert_equal('OmniUnknown', &omnifunc)
+
+%bwipe!
@@ -0,0 +1,24 @@
+#!/bin/sh
+# 在无界面的 Vim 中加载 vimrc 执行测试脚本, 测试用 assert_*() 记录失败
+# 用法: test/run.sh [test/xxx.vim ...]
+cd "$(dirname "$0")/.." || exit 1
+home=$(mktemp -d)
+trap 'rm -rf "$home"' EXIT
+failed=0
+for t in ${@:-test/*.vim}; do
+    rm -f "$home/result"
+    HOME=$home vim -N -u vimrc -i NONE -n -es \
+        -c "try | source $t | catch | call add(v:errors, v:throwpoint . ': ' . v:exception) | endtry" \
+        -c "call writefile(v:errors, \$HOME . '/result')" -c 'qa!' </dev/null >/dev/null 2>&1
+    if [ ! -f "$home/result" ]; then
+        echo "FAIL $t: no result"
+        failed=1
+    elif [ -s "$home/result" ]; then
+        echo "FAIL $t"
+        sed 's/^/    /' "$home/result"
+        failed=1
+    else
+        echo "ok   $t"
+    fi
+done
+exit $failed